@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure Object::GetObject and TypeId::IsChildOf on an aggregate
+// shaped like a node: a handful of objects, some of them a few levels
+// down the TypeId hierarchy, looked up by one of their base classes.
+//
+//   ./bench-get-object --lookups=10000000
+
+#include <iostream>
+#include "ns3/object.h"
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+class BenchBase : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchBase")
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+};
+
+class BenchModel : public BenchBase
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchModel")
+      .SetParent<BenchBase> ()
+    ;
+    return tid;
+  }
+};
+
+class BenchDerivedModel : public BenchModel
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchDerivedModel")
+      .SetParent<BenchModel> ()
+      .AddConstructor<BenchDerivedModel> ()
+    ;
+    return tid;
+  }
+};
+
+class BenchDevice : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchDevice")
+      .SetParent<Object> ()
+    ;
+    return tid;
+  }
+};
+
+class BenchDerivedDevice : public BenchDevice
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchDerivedDevice")
+      .SetParent<BenchDevice> ()
+      .AddConstructor<BenchDerivedDevice> ()
+    ;
+    return tid;
+  }
+};
+
+class BenchNode : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchNode")
+      .SetParent<Object> ()
+      .AddConstructor<BenchNode> ()
+    ;
+    return tid;
+  }
+};
+
+class BenchOther : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchOther")
+      .SetParent<Object> ()
+      .AddConstructor<BenchOther> ()
+    ;
+    return tid;
+  }
+};
+
+int main (int argc, char *argv[])
+{
+  uint32_t lookups = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("lookups", "Number of lookups of each kind.", lookups);
+  cmd.Parse (argc, argv);
+
+  Ptr<BenchNode> node = CreateObject<BenchNode> ();
+  node->AggregateObject (CreateObject<BenchOther> ());
+  node->AggregateObject (CreateObject<BenchDerivedDevice> ());
+  node->AggregateObject (CreateObject<BenchDerivedModel> ());
+
+  SystemWallClockMs clock;
+  uint32_t found = 0;
+  clock.Start ();
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      found += node->GetObject<BenchModel> () != 0;
+      found += node->GetObject<BenchDevice> () != 0;
+    }
+  int64_t getObject = clock.End ();
+
+  TypeId model = BenchDerivedModel::GetTypeId ();
+  TypeId base = BenchBase::GetTypeId ();
+  TypeId other = BenchOther::GetTypeId ();
+  clock.Start ();
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      found += model.IsChildOf (base);
+      found += model.IsChildOf (other);
+    }
+  int64_t isChildOf = clock.End ();
+
+  std::cout << "GetObject " << getObject << "ms, IsChildOf " << isChildOf << "ms for "
+            << 2 * lookups << " lookups each (" << found << " found)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the cost of Simulator::ScheduleWithContext from threads other
+// than the simulation thread, as the reader threads of the emulated
+// devices do: each producer thread schedules its events as fast as it
+// can, while the simulation thread runs and collects them.
+//
+//   ./bench-schedule-with-context --threads=8 --events=1000000
+
+#include <iostream>
+#include <vector>
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/command-line.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+class Bench
+{
+public:
+  Bench (uint32_t threads, uint32_t events);
+  void Run (void);
+private:
+  void Produce (void);
+  void Consume (void);
+  void Poll (void);
+
+  uint32_t m_threads;
+  uint32_t m_events;
+  uint32_t m_consumed;
+  // the time spent by the producers in ScheduleWithContext
+  std::vector<int64_t> m_produceTime;
+  uint32_t m_started;
+};
+
+Bench::Bench (uint32_t threads, uint32_t events)
+  : m_threads (threads),
+    m_events (events),
+    m_consumed (0),
+    m_produceTime (threads),
+    m_started (0)
+{
+}
+
+void
+Bench::Produce (void)
+{
+  uint32_t thread = __sync_fetch_and_add (&m_started, 1);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < m_events; i++)
+    {
+      Simulator::ScheduleWithContext (thread, TimeStep (0), &Bench::Consume, this);
+    }
+  m_produceTime[thread] = clock.End ();
+}
+
+void
+Bench::Consume (void)
+{
+  m_consumed++;
+}
+
+void
+Bench::Poll (void)
+{
+  if (m_consumed == m_threads * m_events)
+    {
+      Simulator::Stop ();
+      return;
+    }
+  Simulator::Schedule (NanoSeconds (1), &Bench::Poll, this);
+}
+
+void
+Bench::Run (void)
+{
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_threads; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&Bench::Produce, this)));
+    }
+  Simulator::Schedule (NanoSeconds (1), &Bench::Poll, this);
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < m_threads; i++)
+    {
+      threads[i]->Start ();
+    }
+  Simulator::Run ();
+  int64_t run = clock.End ();
+  for (uint32_t i = 0; i < m_threads; i++)
+    {
+      threads[i]->Join ();
+    }
+  Simulator::Destroy ();
+
+  int64_t produce = 0;
+  for (uint32_t i = 0; i < m_threads; i++)
+    {
+      produce += m_produceTime[i];
+    }
+  std::cout << m_threads << " threads, " << m_consumed << " events: run " << run << "ms, "
+            << "producers " << produce << "ms, "
+            << (produce == 0 ? 0 : m_consumed / produce) << " events/ms of producer time" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t threads = 8;
+  uint32_t events = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("threads", "Number of producer threads.", threads);
+  cmd.AddValue ("events", "Number of events scheduled by each producer thread.", events);
+  cmd.Parse (argc, argv);
+
+  Bench bench (threads, events);
+  bench.Run ();
+  return 0;
+}
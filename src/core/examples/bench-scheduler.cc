@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compare the event schedulers on a hold model: a fixed population of
+// events, each of which schedules a new event when it expires.
+//
+// With --clustered=true most events are scheduled right after the next
+// boundaries of 50ms slots, as the channel switches of WAVE devices do
+// at the CCH and SCH intervals; otherwise the delays are uniform.
+//
+//   ./bench-scheduler --population=100000 --events=5000000 --clustered=true
+//   ./bench-scheduler --scheduler=ns3::LadderScheduler
+//
+// The wave examples select a scheduler with --SchedulerType, e.g.
+//   ./wave-multiple-channel --SchedulerType=ns3::LadderScheduler
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/command-line.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-wall-clock-ms.h"
+
+using namespace ns3;
+
+class Bench
+{
+public:
+  Bench (bool clustered, uint32_t events);
+  void Start (uint32_t population);
+private:
+  void Expire (void);
+  Time GetDelay (void);
+
+  Ptr<UniformRandomVariable> m_rng;
+  bool m_clustered;
+  uint32_t m_events;
+};
+
+Bench::Bench (bool clustered, uint32_t events)
+  : m_rng (CreateObject<UniformRandomVariable> ()),
+    m_clustered (clustered),
+    m_events (events)
+{
+}
+
+Time
+Bench::GetDelay (void)
+{
+  if (!m_clustered || m_rng->GetInteger (0, 9) == 0)
+    {
+      return MicroSeconds (m_rng->GetInteger (1, 1000000));
+    }
+  // a few microseconds after one of the next four slot boundaries
+  int64_t now = Simulator::Now ().GetMicroSeconds ();
+  int64_t boundary = (now / 50000 + m_rng->GetInteger (1, 4)) * 50000;
+  return MicroSeconds (boundary - now + m_rng->GetInteger (0, 100));
+}
+
+void
+Bench::Start (uint32_t population)
+{
+  for (uint32_t i = 0; i < population; i++)
+    {
+      Simulator::Schedule (GetDelay (), &Bench::Expire, this);
+    }
+}
+
+void
+Bench::Expire (void)
+{
+  if (m_events == 0)
+    {
+      return;
+    }
+  m_events--;
+  Simulator::Schedule (GetDelay (), &Bench::Expire, this);
+}
+
+static void
+RunBench (std::string scheduler, uint32_t population, uint32_t events, bool clustered)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Simulator::SetScheduler (factory);
+
+  Bench bench (clustered, events);
+  SystemWallClockMs clock;
+  clock.Start ();
+  bench.Start (population);
+  int64_t init = clock.End ();
+  clock.Start ();
+  Simulator::Run ();
+  int64_t run = clock.End ();
+  Simulator::Destroy ();
+
+  std::cout << scheduler << " init " << init << "ms run " << run << "ms "
+            << (run == 0 ? 0 : events / run) << " events/ms" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t population = 100000;
+  uint32_t events = 2000000;
+  bool clustered = true;
+  std::string scheduler;
+
+  CommandLine cmd;
+  cmd.AddValue ("population", "Number of events pending at any time.", population);
+  cmd.AddValue ("events", "Number of events to run.", events);
+  cmd.AddValue ("clustered", "Cluster the events at the boundaries of 50ms slots.", clustered);
+  cmd.AddValue ("scheduler", "Scheduler to run, all of them if empty.", scheduler);
+  cmd.Parse (argc, argv);
+
+  std::vector<std::string> schedulers;
+  if (scheduler.empty ())
+    {
+      schedulers.push_back ("ns3::ListScheduler");
+      schedulers.push_back ("ns3::MapScheduler");
+      schedulers.push_back ("ns3::HeapScheduler");
+      schedulers.push_back ("ns3::CalendarScheduler");
+      schedulers.push_back ("ns3::LadderScheduler");
+    }
+  else
+    {
+      schedulers.push_back (scheduler);
+    }
+  for (std::vector<std::string>::const_iterator i = schedulers.begin (); i != schedulers.end (); i++)
+    {
+      RunBench (*i, population, events, clustered);
+    }
+  return 0;
+}
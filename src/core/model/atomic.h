@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NS3_ATOMIC_H
+#define NS3_ATOMIC_H
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+
+/**
+ * \ingroup core
+ * \file
+ * \brief The atomic operations and the thread-local storage of the
+ * lock-free structures shared by the threads, for the compilers which
+ * ns-3 supports: the __sync builtins and __thread of GCC and clang, and
+ * the Interlocked intrinsics and __declspec (thread) of Visual C++.
+ *
+ * Unlike a SystemMutex, they are only meant for the hot paths: the
+ * platforms without threads shall not need them.
+ */
+
+/**
+ * \ingroup core
+ * \def NS_THREAD_LOCAL
+ * Declare a variable of which each thread has its own instance. The
+ * variable shall be of a POD type and its initializer a constant.
+ */
+#ifdef _MSC_VER
+#define NS_THREAD_LOCAL __declspec (thread)
+#else /* _MSC_VER */
+#define NS_THREAD_LOCAL __thread
+#endif /* _MSC_VER */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \param target the pointer to replace
+ * \param value the new value of the pointer
+ * \returns the old value of the pointer
+ *
+ * The exchange is at least an acquire barrier.
+ */
+template <typename T>
+inline T *
+AtomicExchangePointer (T * volatile *target, T *value)
+{
+#ifdef _MSC_VER
+  return static_cast<T *> (_InterlockedExchangePointer (reinterpret_cast<void * volatile *> (target), value));
+#else /* _MSC_VER */
+  return __sync_lock_test_and_set (target, value);
+#endif /* _MSC_VER */
+}
+
+/**
+ * \ingroup core
+ * \param target the pointer to replace
+ * \param oldValue the value which the pointer shall have to be replaced
+ * \param newValue the new value of the pointer
+ * \returns true if the pointer had oldValue and was replaced, false otherwise
+ *
+ * The compare-and-swap is a full barrier.
+ */
+template <typename T>
+inline bool
+AtomicCompareAndSwapPointer (T * volatile *target, T *oldValue, T *newValue)
+{
+#ifdef _MSC_VER
+  return _InterlockedCompareExchangePointer (reinterpret_cast<void * volatile *> (target),
+                                             newValue, oldValue) == oldValue;
+#else /* _MSC_VER */
+  return __sync_bool_compare_and_swap (target, oldValue, newValue);
+#endif /* _MSC_VER */
+}
+
+} // namespace ns3
+
+#endif /* NS3_ATOMIC_H */
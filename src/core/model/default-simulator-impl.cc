@@ -64,15 +64,25 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
-  m_eventsWithContextEmpty = true;
-#if HAVE_PTHREAD_H
+#ifdef HAVE_PTHREAD_H
   m_main = SystemThread::Self();
+  m_eventsWithContext = 0;
+  m_freeEventsWithContext = 0;
+  pthread_key_create (&m_eventsWithContextCache, 0);
 #endif
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  pthread_key_delete (m_eventsWithContextCache);
+  for (std::vector<struct EventWithContext *>::iterator i = m_eventsWithContextBlocks.begin ();
+       i != m_eventsWithContextBlocks.end (); i++)
+    {
+      delete [] *i;
+    }
+#endif
 }
 
 void
@@ -154,33 +164,46 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+#ifdef HAVE_PTHREAD_H
+  if (m_eventsWithContext == 0)
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-#ifdef HAVE_PTHREAD_H 
-    CriticalSection cs (m_eventsWithContextMutex);
-#endif
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  // take all the events at once and put them back in the order they
+  // were scheduled
+  struct EventWithContext *events = AtomicExchangePointer (&m_eventsWithContext,
+                                                           (struct EventWithContext *) 0);
+  struct EventWithContext *last = events;
+  struct EventWithContext *first = 0;
+  while (events != 0)
+    {
+      struct EventWithContext *next = events->next;
+      events->next = first;
+      first = events;
+      events = next;
+    }
+  for (struct EventWithContext *event = first; event != 0; event = event->next)
+    {
+      Scheduler::Event ev;
+      ev.impl = event->event;
+      ev.key.m_ts = m_currentTs + event->timestamp;
+      ev.key.m_context = event->context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+
+  // give them back to the other threads
+  struct EventWithContext *head;
+  do
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
-       Scheduler::Event ev;
-       ev.impl = event.event;
-       ev.key.m_ts = m_currentTs + event.timestamp;
-       ev.key.m_context = event.context;
-       ev.key.m_uid = m_uid;
-       m_uid++;
-       m_unscheduledEvents++;
-       m_events->Insert (ev);
+      head = m_freeEventsWithContext;
+      last->next = head;
     }
+  while (!AtomicCompareAndSwapPointer (&m_freeEventsWithContext, head, first));
+#endif
 }
 
 void
@@ -188,7 +211,7 @@ DefaultSimulatorImpl::Run (void)
 {
   NS_LOG_FUNCTION (this);
   // Set the current threadId as the main threadId
-#ifdef HAVE_PTHREAD_H 
+#ifdef HAVE_PTHREAD_H
   m_main = SystemThread::Self();
 #endif
   ProcessEventsWithContext ();
@@ -225,7 +248,7 @@ EventId
 DefaultSimulatorImpl::Schedule (Time const &time, EventImpl *event)
 {
   NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
-#ifdef HAVE_PTHREAD_H 
+#ifdef HAVE_PTHREAD_H
   NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
 #endif
   Time tAbsolute = time + TimeStep (m_currentTs);
@@ -243,7 +266,7 @@ DefaultSimulatorImpl::Schedule (Time const &time, EventImpl *event)
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
-#ifdef HAVE_PTHREAD_H 
+#ifdef HAVE_PTHREAD_H
 void
 DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
 {
@@ -263,16 +286,42 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
     }
   else
     {
-      EventWithContext ev;
-      ev.context = context;
-      ev.timestamp = time.GetTimeStep ();
-      ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
-      }
+      struct EventWithContext *ev = AllocateEventWithContext ();
+      ev->context = context;
+      ev->timestamp = time.GetTimeStep ();
+      ev->event = event;
+      struct EventWithContext *next;
+      do
+        {
+          next = m_eventsWithContext;
+          ev->next = next;
+        }
+      while (!AtomicCompareAndSwapPointer (&m_eventsWithContext, next, ev));
+    }
+}
+
+struct DefaultSimulatorImpl::EventWithContext *
+DefaultSimulatorImpl::AllocateEventWithContext (void)
+{
+  struct EventWithContext *cache = static_cast<struct EventWithContext *> (pthread_getspecific (m_eventsWithContextCache));
+  if (cache == 0)
+    {
+      cache = AtomicExchangePointer (&m_freeEventsWithContext, (struct EventWithContext *) 0);
+    }
+  if (cache == 0)
+    {
+      const uint32_t n = 256;
+      cache = new struct EventWithContext [n];
+      for (uint32_t i = 0; i < n - 1; i++)
+        {
+          cache[i].next = &cache[i + 1];
+        }
+      cache[n - 1].next = 0;
+      CriticalSection cs (m_eventsWithContextBlocksMutex);
+      m_eventsWithContextBlocks.push_back (cache);
     }
+  pthread_setspecific (m_eventsWithContextCache, cache->next);
+  return cache;
 }
 #else
 void
@@ -294,7 +343,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
 EventId
 DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
 {
-#ifdef HAVE_PTHREAD_H 
+#ifdef HAVE_PTHREAD_H
   NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleNow Thread-unsafe invocation!");
 #endif
 
@@ -312,7 +361,7 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
 EventId
 DefaultSimulatorImpl::ScheduleDestroy (EventImpl *event)
 {
-#ifdef HAVE_PTHREAD_H 
+#ifdef HAVE_PTHREAD_H
   NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleDestroy Thread-unsafe invocation!");
 #endif
   EventId id (Ptr<EventImpl> (event, false), m_currentTs, 0xffffffff, 2);
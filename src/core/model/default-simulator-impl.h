@@ -24,14 +24,19 @@
 #include "simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
-#if HAVE_PTHREAD_H
+#ifdef HAVE_PTHREAD_H
 #include "system-thread.h"
 #include "ns3/system-mutex.h"
+#include "atomic.h"
 #endif
 
 #include "ptr.h"
 
 #include <list>
+#include <vector>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 namespace ns3 {
 
@@ -70,16 +75,29 @@ private:
   void ProcessOneEvent (void);
   void ProcessEventsWithContext (void);
  
+#ifdef HAVE_PTHREAD_H
   struct EventWithContext {
     uint32_t context;
     uint64_t timestamp;
     EventImpl *event;
+    struct EventWithContext *next;
   };
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  EventsWithContext m_eventsWithContext;
-  bool m_eventsWithContextEmpty;
-#ifdef HAVE_PTHREAD_H 
-  SystemMutex m_eventsWithContextMutex;
+  struct EventWithContext *AllocateEventWithContext (void);
+
+  // the events scheduled by the other threads, in reverse order. The
+  // other threads push their events with a compare-and-swap, and the
+  // simulation thread takes them all at once with an exchange. Unlike
+  // this class, RealtimeSimulatorImpl still takes its mutex for them.
+  struct EventWithContext * volatile m_eventsWithContext;
+  // the free EventWithContext, returned by the simulation thread once
+  // their events are scheduled. A thread takes them all at once to
+  // fill its own cache, so they are never popped concurrently.
+  struct EventWithContext * volatile m_freeEventsWithContext;
+  // the thread-specific cache of free EventWithContext
+  pthread_key_t m_eventsWithContextCache;
+  // the blocks of EventWithContext allocated by the other threads
+  std::vector<struct EventWithContext *> m_eventsWithContextBlocks;
+  SystemMutex m_eventsWithContextBlocksMutex;
 #endif
 
   typedef std::list<EventId> DestroyEvents;
@@ -94,7 +112,7 @@ private:
   // number of events that have been inserted but not yet scheduled,
   // not counting the "destroy" events; this is used for validation
   int m_unscheduledEvents;
-#if HAVE_PTHREAD_H
+#ifdef HAVE_PTHREAD_H
   SystemThread::ThreadId m_main;
 #endif
 };
@@ -99,6 +99,41 @@ bool operator != (const EventId &a, const EventId &b)
   return !(a == b);
 }
 
+PeriodicEventId::PeriodicEventId ()
+  : m_eventImpl (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PeriodicEventId::PeriodicEventId (const Ptr<EventImpl> &impl)
+  : m_eventImpl (impl)
+{
+  NS_LOG_FUNCTION (this << impl);
+}
+void
+PeriodicEventId::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_eventImpl != 0)
+    {
+      // the periodic event is scheduled again when it expires, so
+      // the flag is seen by its pending expiration whichever it is
+      m_eventImpl->Cancel ();
+    }
+}
+bool
+PeriodicEventId::IsExpired (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_eventImpl == 0 || m_eventImpl->IsCancelled ();
+}
+bool
+PeriodicEventId::IsRunning (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return !IsExpired ();
+}
+
 
 
 } // namespace ns3
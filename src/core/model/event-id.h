@@ -85,6 +85,38 @@ private:
 bool operator == (const EventId &a, const EventId &b);
 bool operator != (const EventId &a, const EventId &b);
 
+/**
+ * \ingroup events
+ * \brief an identifier for the periodic events.
+ *
+ * A PeriodicEventId is returned by Simulator::SchedulePeriodic and
+ * identifies all the expirations of a periodic event, while an EventId
+ * only identifies one expiration. Cancelling it cancels the pending
+ * expiration, so the event is not scheduled again.
+ */
+class PeriodicEventId {
+public:
+  PeriodicEventId ();
+  // internal.
+  PeriodicEventId (const Ptr<EventImpl> &impl);
+  /**
+   * Cancel the pending expiration of the periodic event and the
+   * following ones.
+   */
+  void Cancel (void);
+  /**
+   * \returns true if the periodic event was cancelled or has expired
+   * for the last time, false otherwise.
+   */
+  bool IsExpired (void) const;
+  /**
+   * \returns true if the periodic event will expire again, false otherwise.
+   */
+  bool IsRunning (void) const;
+private:
+  Ptr<EventImpl> m_eventImpl;
+};
+
 } // namespace ns3
 
 #endif /* EVENT_ID_H */
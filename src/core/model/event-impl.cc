@@ -19,12 +19,37 @@
  */
 
 #include "event-impl.h"
+#include "free-list-pool.h"
 #include "log.h"
 
+#include <new>
+
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
 namespace ns3 {
 
+// the sizes are rounded up to a multiple of EVENT_POOL_ALIGN, and the
+// events larger than EVENT_POOL_ALIGN * EVENT_POOL_CLASSES are not pooled
+static const uint32_t EVENT_POOL_ALIGN = 16;
+static const uint32_t EVENT_POOL_CLASSES = 16;
+// the number of free events kept per size class, beyond which they
+// are given back to the system allocator
+static const uint32_t EVENT_POOL_MAX_FREE = 4096;
+
+/**
+ * The counters of the events of a thread.
+ */
+struct EventPoolCounters
+{
+  // the events allocated minus the events deleted by this thread
+  int64_t live;
+};
+
+typedef FreeListPool<struct EventPoolCounters, EVENT_POOL_CLASSES> EventPool;
+
+// only written outside of Simulator::Run, see SetPoolEnabled
+static bool g_eventPoolEnabled = true;
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -36,6 +61,81 @@ EventImpl::EventImpl ()
   NS_LOG_FUNCTION (this);
 }
 
+void *
+EventImpl::operator new (size_t size)
+{
+  EventPool::Thread *pool = EventPool::Get ();
+  pool->counters.live++;
+  uint32_t sizeClass = (size - 1) / EVENT_POOL_ALIGN;
+  if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  void *p = EventPool::Pop (pool, sizeClass);
+  if (p == 0)
+    {
+      return ::operator new ((sizeClass + 1) * EVENT_POOL_ALIGN);
+    }
+  return p;
+}
+
+void
+EventImpl::operator delete (void *p, size_t size)
+{
+  EventPool::Thread *pool = EventPool::Get ();
+  pool->counters.live--;
+  uint32_t sizeClass = (size - 1) / EVENT_POOL_ALIGN;
+  if (!g_eventPoolEnabled
+      || sizeClass >= EVENT_POOL_CLASSES
+      || pool->nFree[sizeClass] == EVENT_POOL_MAX_FREE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  EventPool::Push (pool, sizeClass, p);
+}
+
+void
+EventImpl::SetPoolEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (enabled);
+  if (g_eventPoolEnabled != enabled)
+    {
+      // the value is the same for each new simulator implementation,
+      // unless it is changed by the user: it is not written again.
+      g_eventPoolEnabled = enabled;
+    }
+  if (!enabled)
+    {
+      EventPool::Release (EventPool::Get ());
+    }
+}
+
+uint64_t
+EventImpl::GetLiveCount (void)
+{
+  int64_t live = 0;
+  for (EventPool::Thread *pool = EventPool::GetThreads (); pool != 0; pool = pool->next)
+    {
+      live += pool->counters.live;
+    }
+  return live;
+}
+
+uint64_t
+EventImpl::GetPooledCount (void)
+{
+  uint64_t pooled = 0;
+  for (EventPool::Thread *pool = EventPool::GetThreads (); pool != 0; pool = pool->next)
+    {
+      for (uint32_t i = 0; i < EVENT_POOL_CLASSES; i++)
+        {
+          pooled += pool->nFree[i];
+        }
+    }
+  return pooled;
+}
+
 void
 EventImpl::Invoke (void)
 {
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 namespace ns3 {
@@ -35,6 +36,11 @@ namespace ns3 {
  * obviously (there are Ref and Unref methods) reference-counted and
  * most subclasses are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The memory of the deleted events is kept in free lists, one per size
+ * rounded up to 16 bytes and per thread, and reused for the next events
+ * of the same size rather than given back to the system allocator. This
+ * may be disabled with the EventImplPool global value.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -58,6 +64,31 @@ public:
    */
   bool IsCancelled (void);
 
+  static void *operator new (size_t size);
+  static void operator delete (void *p, size_t size);
+
+  /**
+   * \param enabled whether the memory of the deleted events is reused
+   *
+   * When the pool is disabled, the events are allocated and deleted by
+   * the system allocator, and the memory kept by the calling thread is
+   * released.
+   *
+   * The threads which run the events read the setting without any lock:
+   * it shall only be changed outside of Simulator::Run, which is the
+   * case when the simulator implementation applies the EventImplPool
+   * global value.
+   */
+  static void SetPoolEnabled (bool enabled);
+  /**
+   * \returns the number of events which are allocated and not deleted yet
+   */
+  static uint64_t GetLiveCount (void);
+  /**
+   * \returns the number of deleted events whose memory is kept for reuse
+   */
+  static uint64_t GetPooledCount (void);
+
 protected:
   virtual void Notify (void) = 0;
 
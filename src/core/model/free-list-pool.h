@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FREE_LIST_POOL_H
+#define FREE_LIST_POOL_H
+
+#include "ns3/core-config.h"
+#include <stdint.h>
+#include <new>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include "atomic.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * \brief Per-thread free lists of memory blocks, one per size class.
+ *
+ * Each thread gets its own free lists and counters the first time it
+ * calls Get, so that the blocks are allocated and deallocated without
+ * any lock. The blocks are allocated one by one by the system allocator:
+ * a block allocated by one thread may be pushed to the free lists of
+ * another one, and may be released to the system allocator whether it
+ * was popped from a free list or not. The free blocks of a thread are
+ * released when it exits, but its counters stay in the list returned
+ * by GetThreads until the end of the process.
+ *
+ * Each instantiation has its own free lists, so each user of this
+ * template is expected to instantiate it with its own Counters type.
+ *
+ * \tparam Counters the counters kept by each thread, zero-initialized
+ * \tparam CLASSES the number of size classes
+ */
+template <typename Counters, uint32_t CLASSES>
+class FreeListPool
+{
+public:
+  /**
+   * The free blocks and the counters of a thread.
+   */
+  struct Thread
+  {
+    /// the first free block of each size class
+    void *free[CLASSES];
+    /// the number of free blocks of each size class
+    uint32_t nFree[CLASSES];
+    /// the counters of the user
+    Counters counters;
+    /// the next thread in the list returned by GetThreads
+    struct Thread *next;
+  };
+
+  /**
+   * \returns the free lists of the calling thread
+   */
+  static struct Thread *Get (void);
+  /**
+   * \returns the first of the threads which ever called Get, linked
+   * by Thread::next, for the counters
+   */
+  static struct Thread *GetThreads (void);
+  /**
+   * \param thread the free lists of the calling thread
+   * \param sizeClass the size class of the block
+   * \returns a free block of sizeClass, or 0 if there is none
+   */
+  static void *Pop (struct Thread *thread, uint32_t sizeClass);
+  /**
+   * \param thread the free lists of the calling thread
+   * \param sizeClass the size class of the block
+   * \param block the block to keep for reuse
+   */
+  static void Push (struct Thread *thread, uint32_t sizeClass, void *block);
+  /**
+   * \param thread the free lists whose blocks are given back to the
+   * system allocator
+   */
+  static void Release (struct Thread *thread);
+
+private:
+  static struct Thread *Create (void);
+  static struct Thread * volatile g_threads;
+#ifdef HAVE_PTHREAD_H
+  static void Exit (void *thread);
+  static void CreateKey (void);
+  static NS_THREAD_LOCAL struct Thread *g_thread;
+  static pthread_key_t g_key;
+  static pthread_once_t g_keyOnce;
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+template <typename Counters, uint32_t CLASSES>
+typename FreeListPool<Counters, CLASSES>::Thread * volatile FreeListPool<Counters, CLASSES>::g_threads = 0;
+
+template <typename Counters, uint32_t CLASSES>
+typename FreeListPool<Counters, CLASSES>::Thread *
+FreeListPool<Counters, CLASSES>::GetThreads (void)
+{
+  return g_threads;
+}
+
+template <typename Counters, uint32_t CLASSES>
+void *
+FreeListPool<Counters, CLASSES>::Pop (struct Thread *thread, uint32_t sizeClass)
+{
+  void *block = thread->free[sizeClass];
+  if (block != 0)
+    {
+      thread->free[sizeClass] = *static_cast<void **> (block);
+      thread->nFree[sizeClass]--;
+    }
+  return block;
+}
+
+template <typename Counters, uint32_t CLASSES>
+void
+FreeListPool<Counters, CLASSES>::Push (struct Thread *thread, uint32_t sizeClass, void *block)
+{
+  *static_cast<void **> (block) = thread->free[sizeClass];
+  thread->free[sizeClass] = block;
+  thread->nFree[sizeClass]++;
+}
+
+template <typename Counters, uint32_t CLASSES>
+void
+FreeListPool<Counters, CLASSES>::Release (struct Thread *thread)
+{
+  for (uint32_t i = 0; i < CLASSES; i++)
+    {
+      void *block;
+      while ((block = Pop (thread, i)) != 0)
+        {
+          ::operator delete (block);
+        }
+    }
+}
+
+template <typename Counters, uint32_t CLASSES>
+typename FreeListPool<Counters, CLASSES>::Thread *
+FreeListPool<Counters, CLASSES>::Create (void)
+{
+  struct Thread *thread = new struct Thread ();
+#ifdef HAVE_PTHREAD_H
+  do
+    {
+      thread->next = g_threads;
+    }
+  while (!AtomicCompareAndSwapPointer (&g_threads, thread->next, thread));
+#else
+  thread->next = g_threads;
+  g_threads = thread;
+#endif /* HAVE_PTHREAD_H */
+  return thread;
+}
+
+#ifdef HAVE_PTHREAD_H
+
+template <typename Counters, uint32_t CLASSES>
+NS_THREAD_LOCAL typename FreeListPool<Counters, CLASSES>::Thread *FreeListPool<Counters, CLASSES>::g_thread = 0;
+template <typename Counters, uint32_t CLASSES>
+pthread_key_t FreeListPool<Counters, CLASSES>::g_key;
+template <typename Counters, uint32_t CLASSES>
+pthread_once_t FreeListPool<Counters, CLASSES>::g_keyOnce = PTHREAD_ONCE_INIT;
+
+template <typename Counters, uint32_t CLASSES>
+void
+FreeListPool<Counters, CLASSES>::Exit (void *thread)
+{
+  // the thread stays in g_threads for its counters
+  Release (static_cast<struct Thread *> (thread));
+}
+
+template <typename Counters, uint32_t CLASSES>
+void
+FreeListPool<Counters, CLASSES>::CreateKey (void)
+{
+  pthread_key_create (&g_key, &Exit);
+}
+
+template <typename Counters, uint32_t CLASSES>
+typename FreeListPool<Counters, CLASSES>::Thread *
+FreeListPool<Counters, CLASSES>::Get (void)
+{
+  if (g_thread == 0)
+    {
+      g_thread = Create ();
+      // release the free blocks of the thread when it exits
+      pthread_once (&g_keyOnce, &CreateKey);
+      pthread_setspecific (g_key, g_thread);
+    }
+  return g_thread;
+}
+
+#else /* HAVE_PTHREAD_H */
+
+template <typename Counters, uint32_t CLASSES>
+typename FreeListPool<Counters, CLASSES>::Thread *
+FreeListPool<Counters, CLASSES>::Get (void)
+{
+  static struct Thread *thread = Create ();
+  return thread;
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+} // namespace ns3
+
+#endif /* FREE_LIST_POOL_H */
@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+// a bucket with more events than this is split into a new rung
+static const uint32_t LADDER_THRESHOLD = 50;
+static const uint32_t LADDER_MAX_RUNGS = 8;
+
+static bool
+IsLater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return b.key < a.key;
+}
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMax (0),
+    m_rungs (LADDER_MAX_RUNGS),
+    m_nRungs (0),
+    m_qSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::GetCurrentStart (const Rung &rung) const
+{
+  if (rung.current < rung.nBuckets)
+    {
+      return rung.start + rung.current * rung.width;
+    }
+  return rung.end;
+}
+uint64_t
+LadderScheduler::GetBottomEnd (void) const
+{
+  if (m_nRungs == 0)
+    {
+      return m_topStart;
+    }
+  return GetCurrentStart (m_rungs[m_nRungs - 1]);
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  m_qSize++;
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty () || ts > m_topMax)
+        {
+          m_topMax = ts;
+        }
+      m_top.push_back (ev);
+    }
+  else
+    {
+      uint32_t i = 0;
+      while (i < m_nRungs && ts < GetCurrentStart (m_rungs[i]))
+        {
+          i++;
+        }
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          uint64_t index = std::min<uint64_t> ((ts - rung.start) / rung.width, rung.nBuckets - 1);
+          rung.buckets[index].push_back (ev);
+        }
+      else
+        {
+          InsertBottom (ev);
+        }
+    }
+  FillBottom ();
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev)
+{
+  m_bottom.insert (std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater), ev);
+  if (m_bottom.size () > LADDER_THRESHOLD
+      && m_nRungs < LADDER_MAX_RUNGS
+      && m_bottom.front ().key.m_ts != m_bottom.back ().key.m_ts)
+    {
+      // too many events were inserted in the near future: spread them on a new rung
+      Bucket events;
+      events.swap (m_bottom);
+      CreateRung (events, GetBottomEnd ());
+    }
+}
+
+void
+LadderScheduler::SortBottom (Bucket &events)
+{
+  NS_ASSERT (m_bottom.empty ());
+  m_bottom.swap (events);
+  std::sort (m_bottom.begin (), m_bottom.end (), IsLater);
+}
+
+void
+LadderScheduler::CreateRung (Bucket &events, uint64_t end)
+{
+  NS_LOG_FUNCTION (this << events.size () << end);
+  uint64_t min = events.front ().key.m_ts;
+  uint64_t max = min;
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      min = std::min (min, i->key.m_ts);
+      max = std::max (max, i->key.m_ts);
+    }
+  if (min == max || m_nRungs == LADDER_MAX_RUNGS)
+    {
+      // the events cannot be spread any further
+      SortBottom (events);
+      return;
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  rung.start = min;
+  rung.width = (max - min) / events.size () + 1;
+  rung.end = end;
+  rung.current = 0;
+  rung.nBuckets = (max - min) / rung.width + 1;
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      // the buckets are never shrunk, to keep the memory of their events
+      rung.buckets.resize (rung.nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      rung.buckets[(i->key.m_ts - min) / rung.width].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  while (m_bottom.empty () && m_qSize != 0)
+    {
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          Bucket events;
+          events.swap (m_top);
+          m_topStart = m_topMax + 1;
+          CreateRung (events, m_topStart);
+          continue;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      rung.current++;
+      if (bucket.size () > LADDER_THRESHOLD)
+        {
+          CreateRung (bucket, GetCurrentStart (rung));
+        }
+      else
+        {
+          SortBottom (bucket);
+        }
+      bucket.clear ();
+    }
+}
+
+bool
+LadderScheduler::RemoveFrom (Bucket &events, const Event &ev)
+{
+  for (Bucket::iterator i = events.begin (); i != events.end (); i++)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          *i = events.back ();
+          events.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_qSize--;
+  FillBottom ();
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  bool found;
+  if (ts >= m_topStart)
+    {
+      found = RemoveFrom (m_top, ev);
+    }
+  else
+    {
+      uint32_t i = 0;
+      while (i < m_nRungs && ts < GetCurrentStart (m_rungs[i]))
+        {
+          i++;
+        }
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          uint64_t index = std::min<uint64_t> ((ts - rung.start) / rung.width, rung.nBuckets - 1);
+          found = RemoveFrom (rung.buckets[index], ev);
+        }
+      else
+        {
+          Bucket::iterator j = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, IsLater);
+          found = j != m_bottom.end () && j->key.m_uid == ev.key.m_uid;
+          if (found)
+            {
+              m_bottom.erase (j);
+            }
+        }
+    }
+  NS_ASSERT_MSG (found, "the event to remove is not in the scheduler");
+  m_qSize--;
+  FillBottom ();
+}
+
+} // namespace ns3
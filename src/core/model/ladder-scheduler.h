@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This class implements the ladder queue described in "Ladder Queue: An
+ * O(1) Priority Queue Structure for Large-Scale Discrete Event Simulation",
+ * W. T. Tang, R. S. M. Goh, I. L.-J. Thng, ACM TOMACS, 2005.
+ *
+ * The events are kept in three tiers:
+ *  - the top, an unsorted list of the events of the far future;
+ *  - the ladder, a stack of rungs of unsorted buckets. The width of the
+ *    buckets of a rung is chosen from the number and the span of the events
+ *    the rung is created from, and a bucket holding too many events is
+ *    split into a new rung of narrower buckets, so the width adapts to
+ *    the density of the events;
+ *  - the bottom, a small sorted list of the events of the near future.
+ * Each event is moved down the tiers a bounded number of times, so insert
+ * and remove cost O(1) amortized whatever the distribution of the events.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  struct Rung
+  {
+    std::vector<Bucket> buckets;
+    // timestamp of the start of the first bucket
+    uint64_t start;
+    // duration of a bucket, the last bucket extends to the end
+    uint64_t width;
+    // number of buckets in use in buckets
+    uint32_t nBuckets;
+    // the end of the timestamps the rung may hold
+    uint64_t end;
+    // index of the first bucket which was not moved down yet
+    uint32_t current;
+  };
+
+  uint64_t GetCurrentStart (const Rung &rung) const;
+  // the end of the timestamps the bottom may hold
+  uint64_t GetBottomEnd (void) const;
+  void InsertBottom (const Event &ev);
+  void SortBottom (Bucket &events);
+  void CreateRung (Bucket &events, uint64_t end);
+  void FillBottom (void);
+  static bool RemoveFrom (Bucket &events, const Event &ev);
+
+  Bucket m_top;
+  // the timestamps of the top are greater than or equal to m_topStart
+  uint64_t m_topStart;
+  // no timestamp of the top is greater than m_topMax
+  uint64_t m_topMax;
+  std::vector<Rung> m_rungs;
+  // number of rungs in use in m_rungs
+  uint32_t m_nRungs;
+  // sorted in descending order, the next event is the last one
+  Bucket m_bottom;
+  // number of events in queue
+  uint32_t m_qSize;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
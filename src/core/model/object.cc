@@ -30,6 +30,9 @@
 #include <sstream>
 #include <cstdlib>
 #include <cstring>
+#ifdef NS3_MULTITHREADED
+#include "atomic.h"
+#endif
 
 
 
@@ -98,6 +101,7 @@ Object::Object ()
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  std::memset (m_aggregates->cache, 0, sizeof (m_aggregates->cache));
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -116,6 +120,13 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  for (uint32_t i = 0; i < sizeof (m_aggregates->cache) / sizeof (Object *); i++)
+    {
+      if (m_aggregates->cache[i] == this)
+        {
+          m_aggregates->cache[i] = 0;
+        }
+    }
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -132,6 +143,7 @@ Object::Object (const Object &o)
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  std::memset (m_aggregates->cache, 0, sizeof (m_aggregates->cache));
   m_aggregates->buffer[0] = this;
 }
 void
@@ -147,33 +159,66 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
-  uint32_t n = m_aggregates->n;
-  TypeId objectTid = Object::GetTypeId ();
-  for (uint32_t i = 0; i < n; i++)
+  // The object last found for this TypeId is checked first. The check
+  // of its type keeps the cache correct when two TypeIds share an entry,
+  // and when another thread replaces the entry under our feet.
+  struct Aggregates *aggregates = m_aggregates;
+  uint32_t entry = tid.GetUid () % (sizeof (aggregates->cache) / sizeof (Object *));
+  Object *current = aggregates->cache[entry];
+  if (current != 0)
     {
-      Object *current = m_aggregates->buffer[i];
       TypeId cur = current->GetInstanceTypeId ();
-      while (cur != tid && cur != objectTid)
+      if (cur != tid && !cur.IsChildOf (tid))
         {
-          cur = cur.GetParent ();
+          current = 0;
         }
-      if (cur == tid)
+    }
+  if (current == 0)
+    {
+      uint32_t n = aggregates->n;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          TypeId cur = aggregates->buffer[i]->GetInstanceTypeId ();
+          if (cur == tid || cur.IsChildOf (tid))
+            {
+              current = aggregates->buffer[i];
+#ifdef NS3_MULTITHREADED
+              // the partitions of a parallel run may look up the same
+              // aggregates concurrently, so the entry is replaced atomically
+              AtomicExchangePointer<Object> (&aggregates->cache[entry], current);
+#else
+              aggregates->cache[entry] = current;
+#endif
+              break;
+            }
+        }
+      if (current == 0)
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          return 0;
         }
     }
-  return 0;
+
+#ifndef NS3_MULTITHREADED
+  // This is an attempt to 'cache' the result of this lookup.
+  // the idea is that if we perform a lookup for a TypeId on this object,
+  // we are likely to perform the same lookup later so, we make sure
+  // that the aggregate array is sorted by the number of accesses
+  // to each object, for the dynamic_cast of GetObject<T> to succeed.
+  // The partitions of a parallel run may look up the same aggregates
+  // concurrently, so the array is not sorted then.
+
+  // first, increment the access count
+  current->m_getObjectCount++;
+  // then, update the sort
+  uint32_t i = 0;
+  while (aggregates->buffer[i] != current)
+    {
+      i++;
+    }
+  UpdateSortedArray (aggregates, i);
+#endif
+  // finally, return the match
+  return current;
 }
 void
 Object::Initialize (void)
@@ -260,6 +305,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  std::memset (aggregates->cache, 0, sizeof (aggregates->cache));
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
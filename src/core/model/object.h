@@ -238,9 +238,14 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * 'n'
+   *
+   * The 'cache' holds the objects last returned by DoGetObject,
+   * indexed by the uid of the TypeId they were looked up with,
+   * modulo the size of the cache.
    */
   struct Aggregates {
     uint32_t n;
+    Object *cache[8];
     Object *buffer[1];
   };
 
@@ -22,6 +22,7 @@
 #ifndef SIMPLE_REF_COUNT_H
 #define SIMPLE_REF_COUNT_H
 
+#include "ns3/core-config.h"
 #include "empty.h"
 #include "default-deleter.h"
 #include "assert.h"
@@ -101,7 +102,11 @@ public:
   inline void Ref (void) const
   {
     NS_ASSERT (m_count < std::numeric_limits<uint32_t>::max());
+#ifdef NS3_MULTITHREADED
+    __sync_add_and_fetch (&m_count, 1);
+#else
     m_count++;
+#endif
   }
   /**
    * Decrement the reference count. This method should not be called
@@ -111,8 +116,12 @@ public:
    */
   inline void Unref (void) const
   {
+#ifdef NS3_MULTITHREADED
+    if (__sync_sub_and_fetch (&m_count, 1) == 0)
+#else
     m_count--;
     if (m_count == 0)
+#endif
       {
         DELETER::Delete (static_cast<T*> (const_cast<SimpleRefCount *> (this)));
       }
@@ -26,6 +26,7 @@
 
 #include "ptr.h"
 #include "string.h"
+#include "boolean.h"
 #include "object-factory.h"
 #include "global-value.h"
 #include "assert.h"
@@ -55,6 +56,11 @@ GlobalValue g_schedTypeImpl ("SchedulerType",
                              TypeIdValue (MapScheduler::GetTypeId ()),
                              MakeTypeIdChecker ());
 
+GlobalValue g_eventImplPool ("EventImplPool",
+                             "Whether the memory of the deleted events is reused for the next ones",
+                             BooleanValue (true),
+                             MakeBooleanChecker ());
+
 static void
 TimePrinter (std::ostream &os)
 {
@@ -103,6 +109,11 @@ static SimulatorImpl * GetImpl (void)
         factory.SetTypeId (s.Get ());
         (*pimpl)->SetScheduler (factory);
       }
+      {
+        BooleanValue pool;
+        g_eventImplPool.GetValue (pool);
+        EventImpl::SetPoolEnabled (pool.Get ());
+      }
 
 //
 // Note: we call LogSetTimePrinter _after_ creating the implementation
@@ -229,6 +240,61 @@ Simulator::DoScheduleDestroy (EventImpl *impl)
   return GetImpl ()->ScheduleDestroy (impl);
 }
 
+/**
+ * \internal
+ * An event which invokes another event "count" times, every "period".
+ * It schedules itself again when it expires, so only its next
+ * expiration is in the event list.
+ */
+class PeriodicEventImpl : public EventImpl
+{
+public:
+  PeriodicEventImpl (Time const &period, uint32_t count, EventImpl *event)
+    : m_period (period),
+      m_count (count),
+      m_event (event, false)
+  {
+  }
+protected:
+  virtual void Notify (void)
+  {
+    m_count--;
+    if (m_count != 0)
+      {
+        // the next expiration is scheduled before the events
+        // scheduled by this one, but after the events scheduled
+        // for the same time before this expiration.
+        Simulator::Schedule (m_period, Ptr<EventImpl> (this));
+      }
+    else
+      {
+        // the PeriodicEventId is expired from the last expiration on
+        Cancel ();
+      }
+    m_event->Invoke ();
+  }
+private:
+  Time m_period;
+  uint32_t m_count;
+  Ptr<EventImpl> m_event;
+};
+
+PeriodicEventId
+Simulator::DoSchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                               EventImpl *impl)
+{
+  Ptr<EventImpl> event = Create<PeriodicEventImpl> (period, count, impl);
+  if (count != 0)
+    {
+      Schedule (time, event);
+    }
+  else
+    {
+      event->Cancel ();
+    }
+  return PeriodicEventId (event);
+}
+
 
 EventId
 Simulator::Schedule (Time const &time, void (*f)(void))
@@ -254,6 +320,13 @@ Simulator::ScheduleDestroy (void (*f)(void))
   return DoScheduleDestroy (MakeEvent (f));
 }
 
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             void (*f)(void))
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (f));
+}
+
 void
 Simulator::Remove (const EventId &ev)
 {
@@ -332,6 +405,9 @@ Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
   g_schedTypeImpl.GetValue (s);
   factory.SetTypeId (s.Get ());
   impl->SetScheduler (factory);
+  BooleanValue pool;
+  g_eventImplPool.GetValue (pool);
+  EventImpl::SetPoolEnabled (pool.Get ());
 //
 // Note: we call LogSetTimePrinter _after_ creating the implementation
 // object because the act of creation can trigger calls to the logging 
@@ -342,6 +418,18 @@ Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
   LogSetTimePrinter (&TimePrinter);
   LogSetNodePrinter (&NodePrinter);
 }
+uint64_t
+Simulator::GetLiveEventCount (void)
+{
+  return EventImpl::GetLiveCount ();
+}
+
+uint64_t
+Simulator::GetPooledEventCount (void)
+{
+  return EventImpl::GetPooledCount ();
+}
+
 Ptr<SimulatorImpl>
 Simulator::GetImplementation (void)
 {
@@ -681,6 +681,197 @@ public:
             typename T1, typename T2, typename T3, typename T4, typename T5>
   static EventId ScheduleDestroy (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5 a5);
 
+  /**
+   * Schedule an event to expire at the relative time "time", and then
+   * every "period" until it has expired "count" times.
+   *
+   * Only the next expiration of the event is in the event list at any
+   * time: it is scheduled when the previous one expires, before the
+   * method is invoked. So a periodic event costs one entry in the event
+   * list whatever its count. An expiration still runs before the events
+   * scheduled by the previous one for the same time, but it runs after
+   * the other events scheduled for the same time before the previous
+   * expiration: this order differs from the one of expirations which
+   * would all have been scheduled now. The PeriodicEventId returned
+   * cancels the expirations which are left, e.g. when the node or the
+   * application of the event stops.
+   *
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @returns an id for the periodic event.
+   */
+  template <typename MEM, typename OBJ>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           MEM mem_ptr, OBJ obj);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @param a1 the first argument to pass to the invoked method
+   * @returns an id for the periodic event.
+   */
+  template <typename MEM, typename OBJ,
+            typename T1>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           MEM mem_ptr, OBJ obj, T1 a1);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @param a1 the first argument to pass to the invoked method
+   * @param a2 the second argument to pass to the invoked method
+   * @returns an id for the periodic event.
+   */
+  template <typename MEM, typename OBJ,
+            typename T1, typename T2>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           MEM mem_ptr, OBJ obj, T1 a1, T2 a2);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @param a1 the first argument to pass to the invoked method
+   * @param a2 the second argument to pass to the invoked method
+   * @param a3 the third argument to pass to the invoked method
+   * @returns an id for the periodic event.
+   */
+  template <typename MEM, typename OBJ,
+            typename T1, typename T2, typename T3>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @param a1 the first argument to pass to the invoked method
+   * @param a2 the second argument to pass to the invoked method
+   * @param a3 the third argument to pass to the invoked method
+   * @param a4 the fourth argument to pass to the invoked method
+   * @returns an id for the periodic event.
+   */
+  template <typename MEM, typename OBJ,
+            typename T1, typename T2, typename T3, typename T4>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param mem_ptr member method pointer to invoke
+   * @param obj the object on which to invoke the member method
+   * @param a1 the first argument to pass to the invoked method
+   * @param a2 the second argument to pass to the invoked method
+   * @param a3 the third argument to pass to the invoked method
+   * @param a4 the fourth argument to pass to the invoked method
+   * @param a5 the fifth argument to pass to the invoked method
+   * @returns an id for the periodic event.
+   */
+  template <typename MEM, typename OBJ,
+            typename T1, typename T2, typename T3, typename T4, typename T5>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param f the function to invoke
+   * @returns an id for the periodic event.
+   */
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           void (*f)(void));
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param f the function to invoke
+   * @param a1 the first argument to pass to the function to invoke
+   * @returns an id for the periodic event.
+   */
+  template <typename U1,
+            typename T1>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           void (*f)(U1), T1 a1);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param f the function to invoke
+   * @param a1 the first argument to pass to the function to invoke
+   * @param a2 the second argument to pass to the function to invoke
+   * @returns an id for the periodic event.
+   */
+  template <typename U1, typename U2,
+            typename T1, typename T2>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           void (*f)(U1,U2), T1 a1, T2 a2);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param f the function to invoke
+   * @param a1 the first argument to pass to the function to invoke
+   * @param a2 the second argument to pass to the function to invoke
+   * @param a3 the third argument to pass to the function to invoke
+   * @returns an id for the periodic event.
+   */
+  template <typename U1, typename U2, typename U3,
+            typename T1, typename T2, typename T3>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param f the function to invoke
+   * @param a1 the first argument to pass to the function to invoke
+   * @param a2 the second argument to pass to the function to invoke
+   * @param a3 the third argument to pass to the function to invoke
+   * @param a4 the fourth argument to pass to the function to invoke
+   * @returns an id for the periodic event.
+   */
+  template <typename U1, typename U2, typename U3, typename U4,
+            typename T1, typename T2, typename T3, typename T4>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4);
+
+  /**
+   * @param time the relative expiration time of the first expiration.
+   * @param period the delay between two expirations.
+   * @param count the number of expirations.
+   * @param f the function to invoke
+   * @param a1 the first argument to pass to the function to invoke
+   * @param a2 the second argument to pass to the function to invoke
+   * @param a3 the third argument to pass to the function to invoke
+   * @param a4 the fourth argument to pass to the function to invoke
+   * @param a5 the fifth argument to pass to the function to invoke
+   * @returns an id for the periodic event.
+   */
+  template <typename U1, typename U2, typename U3, typename U4, typename U5,
+            typename T1, typename T2, typename T3, typename T4, typename T5>
+  static PeriodicEventId SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                           void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5 a5);
+
   /**
    * Remove an event from the event list. 
    * This method has the same visible effect as the 
@@ -794,6 +985,18 @@ public:
    *          MPI or other distributed simulations
    */
   static uint32_t GetSystemId (void);
+
+  /**
+   * \returns the number of events which are allocated and not deleted
+   *          yet, that is the pending events and the expired or
+   *          cancelled events still referenced by an EventId.
+   */
+  static uint64_t GetLiveEventCount (void);
+  /**
+   * \returns the number of deleted events whose memory is kept for
+   *          the next events, see the EventImplPool global value.
+   */
+  static uint64_t GetPooledEventCount (void);
 private:
   Simulator ();
   ~Simulator ();
@@ -801,6 +1004,8 @@ private:
   static EventId DoSchedule (Time const &time, EventImpl *event);
   static EventId DoScheduleNow (EventImpl *event);
   static EventId DoScheduleDestroy (EventImpl *event);
+  static PeriodicEventId DoSchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                                             EventImpl *event);
 };
 
 /**
@@ -1160,6 +1365,104 @@ Simulator::ScheduleDestroy (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a
   return DoScheduleDestroy (MakeEvent (f, a1, a2, a3, a4, a5));
 }
 
+template <typename MEM, typename OBJ>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             MEM mem_ptr, OBJ obj)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (mem_ptr, obj));
+}
+
+template <typename MEM, typename OBJ,
+          typename T1>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             MEM mem_ptr, OBJ obj, T1 a1)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (mem_ptr, obj, a1));
+}
+
+template <typename MEM, typename OBJ,
+          typename T1, typename T2>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (mem_ptr, obj, a1, a2));
+}
+
+template <typename MEM, typename OBJ,
+          typename T1, typename T2, typename T3>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (mem_ptr, obj, a1, a2, a3));
+}
+
+template <typename MEM, typename OBJ,
+          typename T1, typename T2, typename T3, typename T4>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (mem_ptr, obj, a1, a2, a3, a4));
+}
+
+template <typename MEM, typename OBJ,
+          typename T1, typename T2, typename T3, typename T4, typename T5>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (mem_ptr, obj, a1, a2, a3, a4, a5));
+}
+
+template <typename U1,
+          typename T1>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             void (*f)(U1), T1 a1)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (f, a1));
+}
+
+template <typename U1, typename U2,
+          typename T1, typename T2>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             void (*f)(U1,U2), T1 a1, T2 a2)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (f, a1, a2));
+}
+
+template <typename U1, typename U2, typename U3,
+          typename T1, typename T2, typename T3>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             void (*f)(U1,U2,U3), T1 a1, T2 a2, T3 a3)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (f, a1, a2, a3));
+}
+
+template <typename U1, typename U2, typename U3, typename U4,
+          typename T1, typename T2, typename T3, typename T4>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             void (*f)(U1,U2,U3,U4), T1 a1, T2 a2, T3 a3, T4 a4)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (f, a1, a2, a3, a4));
+}
+
+template <typename U1, typename U2, typename U3, typename U4, typename U5,
+          typename T1, typename T2, typename T3, typename T4, typename T5>
+PeriodicEventId
+Simulator::SchedulePeriodic (Time const &time, Time const &period, uint32_t count,
+                             void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
+{
+  return DoSchedulePeriodic (time, period, count, MakeEvent (f, a1, a2, a3, a4, a5));
+}
+
 } // namespace ns3
 
 #endif /* SIMULATOR_H */
@@ -81,6 +81,7 @@ public:
   std::string GetName (uint16_t uid) const;
   TypeId::hash_t GetHash (uint16_t uid) const;
   uint16_t GetParent (uint16_t uid) const;
+  bool IsChildOf (uint16_t uid, uint16_t other) const;
   std::string GetGroupName (uint16_t uid) const;
   Callback<ObjectBase *> GetConstructor (uint16_t uid) const;
   bool HasConstructor (uint16_t uid) const;
@@ -115,6 +116,9 @@ private:
     std::string name;
     TypeId::hash_t hash;
     uint16_t parent;
+    // the uids from the root of the hierarchy down to this one, so
+    // that IsChildOf is a single lookup instead of a walk up the parents
+    std::vector<uint16_t> ancestors;
     std::string groupName;
     bool hasConstructor;
     Callback<ObjectBase *> constructor;
@@ -210,6 +214,7 @@ IidManager::AllocateUid (std::string name)
   information.name = name;
   information.hash = hash;
   information.parent = 0;
+  information.ancestors.push_back (m_information.size () + 1);
   information.groupName = "";
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
@@ -238,6 +243,12 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  information->ancestors.clear ();
+  if (parent != uid && parent != 0)
+    {
+      information->ancestors = LookupInformation (parent)->ancestors;
+    }
+  information->ancestors.push_back (uid);
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -315,6 +326,14 @@ IidManager::GetParent (uint16_t uid) const
   struct IidInformation *information = LookupInformation (uid);
   return information->parent;
 }
+bool
+IidManager::IsChildOf (uint16_t uid, uint16_t other) const
+{
+  NS_LOG_FUNCTION (this << uid << other);
+  const std::vector<uint16_t> &ancestors = LookupInformation (uid)->ancestors;
+  std::vector<uint16_t>::size_type depth = LookupInformation (other)->ancestors.size () - 1;
+  return depth + 1 < ancestors.size () && ancestors[depth] == other;
+}
 std::string 
 IidManager::GetGroupName (uint16_t uid) const
 {
@@ -638,12 +657,7 @@ bool
 TypeId::IsChildOf (TypeId other) const
 {
   NS_LOG_FUNCTION (this << other);
-  TypeId tmp = *this;
-  while (tmp != other && tmp != tmp.GetParent ())
-    {
-      tmp = tmp.GetParent ();
-    }
-  return tmp == other && *this != other;
+  return Singleton<IidManager>::Get ()->IsChildOf (m_tid, other.m_tid);
 }
 std::string 
 TypeId::GetGroupName (void) const
@@ -335,6 +335,69 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+// ===========================================================================
+// Test case to make sure that the objects found by GetObject are still the
+// right ones when they are found again through the cache of the aggregation.
+// ===========================================================================
+class GetObjectCacheTestCase : public TestCase
+{
+public:
+  GetObjectCacheTestCase ();
+  virtual ~GetObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectCacheTestCase::GetObjectCacheTestCase ()
+  : TestCase ("Check repeated GetObject on an aggregation")
+{
+}
+
+GetObjectCacheTestCase::~GetObjectCacheTestCase ()
+{
+}
+
+void
+GetObjectCacheTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (BaseA::GetTypeId ()), true, "DerivedA is not a child of BaseA");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (Object::GetTypeId ()), true, "DerivedA is not a child of Object");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (DerivedA::GetTypeId ()), false, "DerivedA is a child of itself");
+  NS_TEST_ASSERT_MSG_EQ (BaseA::GetTypeId ().IsChildOf (DerivedA::GetTypeId ()), false, "BaseA is a child of DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (BaseB::GetTypeId ()), false, "DerivedA is a child of BaseB");
+
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  baseA->AggregateObject (derivedB);
+
+  //
+  // Look up every type several times, through both objects and with the
+  // TypeId given explicitly, so that the lookups are not short-cut by the
+  // dynamic_cast of GetObject<T> ().
+  //
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseA> (BaseA::GetTypeId ()), baseA, "Wrong BaseA through baseA");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (BaseA::GetTypeId ()), baseA, "Wrong BaseA through derivedB");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (BaseB::GetTypeId ()), derivedB, "Wrong BaseB through baseA");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (DerivedB::GetTypeId ()), derivedB, "Wrong DerivedB through baseA");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedA> (DerivedA::GetTypeId ()), 0, "Unexpectedly found a DerivedA through baseA");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (DerivedA::GetTypeId ()), 0, "Unexpectedly found a DerivedA through derivedB");
+    }
+
+  //
+  // The objects aggregated later must be found too.
+  //
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseA> (BaseA::GetTypeId ()), derivedA, "Wrong BaseA through derivedA");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (BaseB::GetTypeId ()), 0, "Unexpectedly found a BaseB through derivedA");
+  Ptr<BaseB> baseB = CreateObject<BaseB> ();
+  derivedA->AggregateObject (baseB);
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (BaseB::GetTypeId ()), baseB, "Wrong BaseB through derivedA");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedA> (DerivedA::GetTypeId ()), derivedA, "Wrong DerivedA through baseB");
+}
+
 // ===========================================================================
 // Test case to make sure that an Object factory can create Objects
 // ===========================================================================
@@ -421,6 +484,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
+  AddTestCase (new GetObjectCacheTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
 }
 
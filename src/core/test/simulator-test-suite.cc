@@ -19,10 +19,15 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable-stream.h"
+
+#include <vector>
 
 using namespace ns3;
 
@@ -417,6 +422,18 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::ScheduleDestroy (&SimulatorTemplateTestCase::bar4, Ptr<SimulatorTemplateTestCase> (this), 0, 0, 0, 0);
   Simulator::ScheduleDestroy (&SimulatorTemplateTestCase::bar5, Ptr<SimulatorTemplateTestCase> (this), 0, 0, 0, 0, 0);
 
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &SimulatorTemplateTestCase::bar0, this);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &SimulatorTemplateTestCase::bar1, this, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &SimulatorTemplateTestCase::bar2, this, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &SimulatorTemplateTestCase::bar3, this, 0, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &SimulatorTemplateTestCase::bar4, this, 0, 0, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &SimulatorTemplateTestCase::bar5, this, 0, 0, 0, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &foo0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &foo1, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &foo2, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &foo3, 0, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &foo4, 0, 0, 0, 0);
+  Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), 1, &foo5, 0, 0, 0, 0, 0);
 
   // the code below does not compile, as expected.
   //Simulator::Schedule (Seconds (0.0), &cber1, 0.0);
@@ -459,6 +476,249 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorPeriodicTestCase : public TestCase
+{
+public:
+  SimulatorPeriodicTestCase ();
+  virtual void DoRun (void);
+  void Periodic (int a);
+  void Other (void);
+  void Tie (void);
+  std::vector<uint64_t> m_times;
+  std::vector<int> m_order;
+};
+
+SimulatorPeriodicTestCase::SimulatorPeriodicTestCase ()
+  : TestCase ("Check that periodic events expire count times, before the events scheduled by the previous expiration")
+{
+}
+
+void
+SimulatorPeriodicTestCase::Periodic (int a)
+{
+  m_times.push_back (Now ().GetMicroSeconds ());
+  m_order.push_back (a);
+  // scheduled after the next expiration of the periodic event
+  Simulator::Schedule (MicroSeconds (10), &SimulatorPeriodicTestCase::Other, this);
+}
+
+void
+SimulatorPeriodicTestCase::Other (void)
+{
+  m_order.push_back (0);
+}
+
+void
+SimulatorPeriodicTestCase::Tie (void)
+{
+  m_order.push_back (3);
+}
+
+void
+SimulatorPeriodicTestCase::DoRun (void)
+{
+  Simulator::SchedulePeriodic (MicroSeconds (5), MicroSeconds (10), 3, &SimulatorPeriodicTestCase::Periodic, this, 1);
+  Simulator::SchedulePeriodic (MicroSeconds (5), MicroSeconds (10), 0, &SimulatorPeriodicTestCase::Periodic, this, 2);
+  // scheduled before the second expiration of the periodic event
+  Simulator::Schedule (MicroSeconds (15), &SimulatorPeriodicTestCase::Tie, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_times.size (), 3, "The periodic event shall expire 3 times");
+  NS_TEST_EXPECT_MSG_EQ (m_times[0], 5, "The first expiration shall be after the delay");
+  NS_TEST_EXPECT_MSG_EQ (m_times[1], 15, "The expirations shall be one period apart");
+  NS_TEST_EXPECT_MSG_EQ (m_times[2], 25, "The expirations shall be one period apart");
+  NS_TEST_ASSERT_MSG_EQ (m_order.size (), 7, "Every expiration shall schedule one event");
+  int order[] = {1, 3, 1, 0, 1, 0, 0};
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_order[i], order[i], "The expiration shall run before the events scheduled by the previous one, "
+                             "and after the ones scheduled before the previous one");
+    }
+}
+
+class SimulatorPeriodicCancelTestCase : public TestCase
+{
+public:
+  SimulatorPeriodicCancelTestCase ();
+  virtual void DoRun (void);
+  void Periodic (void);
+  void Cancel (void);
+  PeriodicEventId m_id;
+  std::vector<uint64_t> m_times;
+};
+
+SimulatorPeriodicCancelTestCase::SimulatorPeriodicCancelTestCase ()
+  : TestCase ("Check that a cancelled periodic event does not expire again")
+{
+}
+
+void
+SimulatorPeriodicCancelTestCase::Periodic (void)
+{
+  m_times.push_back (Now ().GetMicroSeconds ());
+}
+
+void
+SimulatorPeriodicCancelTestCase::Cancel (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_id.IsRunning (), true, "The periodic event shall be running until it is cancelled");
+  m_id.Cancel ();
+  NS_TEST_EXPECT_MSG_EQ (m_id.IsExpired (), true, "The cancelled periodic event shall be expired");
+}
+
+void
+SimulatorPeriodicCancelTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_id.IsExpired (), true, "A default PeriodicEventId shall be expired");
+  m_id = Simulator::SchedulePeriodic (MicroSeconds (5), MicroSeconds (10), 100, &SimulatorPeriodicCancelTestCase::Periodic, this);
+  // cancelled after the second expiration, when the third one is pending
+  Simulator::Schedule (MicroSeconds (20), &SimulatorPeriodicCancelTestCase::Cancel, this);
+  PeriodicEventId finished = Simulator::SchedulePeriodic (MicroSeconds (5), MicroSeconds (10), 1, &SimulatorPeriodicCancelTestCase::Periodic, this);
+  PeriodicEventId never = Simulator::SchedulePeriodic (MicroSeconds (5), MicroSeconds (10), 0, &SimulatorPeriodicCancelTestCase::Periodic, this);
+  NS_TEST_EXPECT_MSG_EQ (finished.IsRunning (), true, "The periodic event shall be running before its expiration");
+  NS_TEST_EXPECT_MSG_EQ (never.IsExpired (), true, "A periodic event with no expiration shall be expired");
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (finished.IsExpired (), true, "The periodic event shall be expired after its last expiration");
+  NS_TEST_ASSERT_MSG_EQ (m_times.size (), 3, "The cancelled event shall expire twice and the other one once");
+  NS_TEST_EXPECT_MSG_EQ (m_times[0], 5, "The first expirations shall be after the delay");
+  NS_TEST_EXPECT_MSG_EQ (m_times[1], 5, "The first expirations shall be after the delay");
+  NS_TEST_EXPECT_MSG_EQ (m_times[2], 15, "The cancelled event shall expire before it is cancelled only");
+}
+
+class LadderSchedulerTestCase : public TestCase
+{
+public:
+  LadderSchedulerTestCase ();
+  virtual void DoRun (void);
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase ()
+  : TestCase ("Check that LadderScheduler returns the events of a clustered workload in the order of MapScheduler")
+{
+}
+
+void
+LadderSchedulerTestCase::DoRun (void)
+{
+  Ptr<Scheduler> ladder = CreateObject<LadderScheduler> ();
+  Ptr<Scheduler> map = CreateObject<MapScheduler> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<Scheduler::Event> pending;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  for (uint32_t step = 0; step < 20000; step++)
+    {
+      uint32_t action = rng->GetInteger (0, 9);
+      if (action < 6 || pending.empty ())
+        {
+          // most events are clustered at the next boundaries of 50ms slots,
+          // the others are spread over the next seconds.
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          if (rng->GetInteger (0, 3) != 0)
+            {
+              ev.key.m_ts = (now / 50000 + rng->GetInteger (1, 3)) * 50000 + rng->GetInteger (0, 4);
+            }
+          else
+            {
+              ev.key.m_ts = now + rng->GetInteger (0, 5000000);
+            }
+          ladder->Insert (ev);
+          map->Insert (ev);
+          pending.push_back (ev);
+        }
+      else if (action < 7)
+        {
+          uint32_t i = rng->GetInteger (0, pending.size () - 1);
+          ladder->Remove (pending[i]);
+          map->Remove (pending[i]);
+          pending[i] = pending.back ();
+          pending.pop_back ();
+        }
+      else
+        {
+          Scheduler::Event next = map->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ladder->PeekNext ().key.m_uid, next.key.m_uid, "The next event shall be the same");
+          NS_TEST_ASSERT_MSG_EQ (ladder->RemoveNext ().key.m_uid, next.key.m_uid, "The removed event shall be the same");
+          now = next.key.m_ts;
+          for (uint32_t i = 0; i < pending.size (); i++)
+            {
+              if (pending[i].key.m_uid == next.key.m_uid)
+                {
+                  pending[i] = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), map->IsEmpty (), "The schedulers shall hold the same events");
+    }
+  while (!map->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (ladder->RemoveNext ().key.m_uid, map->RemoveNext ().key.m_uid, "The removed event shall be the same");
+    }
+  NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), true, "The ladder shall be empty");
+}
+
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+  virtual void DoRun (void);
+  void Expire (uint32_t i);
+  uint32_t m_expired;
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that the memory of the expired events is reused")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Expire (uint32_t i)
+{
+  m_expired++;
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  m_expired = 0;
+  uint64_t live = Simulator::GetLiveEventCount ();
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Expire, this, i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), live + 100, "The scheduled events shall be live");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_expired, 100, "Every event shall expire");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), live, "The expired events shall be deleted");
+  uint64_t pooled = Simulator::GetPooledEventCount ();
+  NS_TEST_EXPECT_MSG_GT (pooled, 99, "The memory of the expired events shall be kept");
+
+  EventId id = Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::Expire, this, 0);
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetPooledEventCount (), pooled - 1, "A new event shall reuse the memory of an expired one");
+  Simulator::Cancel (id);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_expired, 100, "The cancelled event shall not expire");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetLiveEventCount (), live + 1, "The cancelled event shall be referenced by its id");
+  id = EventId ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetPooledEventCount (), pooled, "The memory of the cancelled event shall be kept");
+
+  EventImpl::SetPoolEnabled (false);
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::Expire, this, 0);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_expired, 101, "Every event shall expire");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetPooledEventCount (), 0, "The memory of the events shall be released");
+  EventImpl::SetPoolEnabled (true);
+  Simulator::Destroy ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +735,11 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorPeriodicTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorPeriodicCancelTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
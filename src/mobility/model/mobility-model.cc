@@ -46,6 +46,9 @@ MobilityModel::GetTypeId (void)
     .AddTraceSource ("CourseChange", 
                      "The value of the position and/or velocity vector changed",
                      MakeTraceSourceAccessor (&MobilityModel::m_courseChangeTrace))
+    .AddTraceSource ("Dispose",
+                     "The mobility model is being disposed",
+                     MakeTraceSourceAccessor (&MobilityModel::m_disposeTrace))
   ;
   return tid;
 }
@@ -98,6 +101,19 @@ MobilityModel::NotifyCourseChange (void) const
   m_courseChangeTrace (this);
 }
 
+void
+MobilityModel::DoDispose (void)
+{
+  // a mobility model deleted without an explicit Dispose is disposed
+  // with no reference left, and no listener may hold one: do not
+  // resurrect it through the Ptr of the trace.
+  if (GetReferenceCount () > 0)
+    {
+      m_disposeTrace (this);
+    }
+  Object::DoDispose ();
+}
+
 int64_t
 MobilityModel::AssignStreams (int64_t start)
 {
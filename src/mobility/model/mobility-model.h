@@ -81,6 +81,11 @@ protected:
    * position changes to notify course change listeners.
    */
   void NotifyCourseChange (void) const;
+  /**
+   * Notify the Dispose listeners. Subclasses which override this
+   * method must chain up to it.
+   */
+  virtual void DoDispose (void);
 private:
   /**
    * \return the current position.
@@ -115,6 +120,11 @@ private:
    * or position has occurred.
    */
   TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
+  /**
+   * Used to alert subscribers, such as the caches of the propagation
+   * models, that this mobility model is going away.
+   */
+  TracedCallback<Ptr<const MobilityModel> > m_disposeTrace;
 
 };
 
@@ -0,0 +1,850 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/make-event.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+// the partitions are run by POSIX threads: this file is not built by
+// the Windows projects, which do not build the system threads either
+#ifndef WIN32
+
+/**
+ * \brief the barrier the threads of the partitions wait at
+ *
+ * pthread_barrier_t is not available on all the platforms, and the
+ * SystemCondition cannot be reused safely by several waiters.
+ */
+class PartitionBarrier
+{
+public:
+  PartitionBarrier (uint32_t count);
+  ~PartitionBarrier ();
+  void Wait (void);
+private:
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_cond;
+  uint32_t m_count;
+  uint32_t m_waiting;
+  uint32_t m_generation;
+};
+
+PartitionBarrier::PartitionBarrier (uint32_t count)
+  : m_count (count),
+    m_waiting (0),
+    m_generation (0)
+{
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_cond, 0);
+}
+
+PartitionBarrier::~PartitionBarrier ()
+{
+  pthread_cond_destroy (&m_cond);
+  pthread_mutex_destroy (&m_mutex);
+}
+
+void
+PartitionBarrier::Wait (void)
+{
+  pthread_mutex_lock (&m_mutex);
+  uint32_t generation = m_generation;
+  m_waiting++;
+  if (m_waiting == m_count)
+    {
+      m_waiting = 0;
+      m_generation++;
+      pthread_cond_broadcast (&m_cond);
+    }
+  else
+    {
+      while (generation == m_generation)
+        {
+          pthread_cond_wait (&m_cond, &m_mutex);
+        }
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+
+// the partition run by the calling thread, null out of the runs
+static pthread_key_t g_currentPartition;
+static pthread_once_t g_currentPartitionOnce = PTHREAD_ONCE_INIT;
+
+static void
+CreateCurrentPartitionKey (void)
+{
+  pthread_key_create (&g_currentPartition, 0);
+}
+
+static const uint64_t MAX_TS = 0x7fffffffffffffffLL;
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  pthread_once (&g_currentPartitionOnce, &CreateCurrentPartitionKey);
+  m_barrier = 0;
+  m_lookAhead = MAX_TS;
+  m_stopTs = MAX_TS;
+  m_stopUid = 0;
+  m_stop = false;
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_uid = 4;
+  m_firstPendingUid = 0;
+  // before ::Run is entered, the m_currentUid will be zero
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = 0xffffffff;
+  m_main = SystemThread::Self ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      Partition *partition = *i;
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  delete m_barrier;
+  m_barrier = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      Ptr<Scheduler> events = schedulerFactory.Create<Scheduler> ();
+      while (!(*i)->events->IsEmpty ())
+        {
+          Scheduler::Event next = (*i)->events->RemoveNext ();
+          events->Insert (next);
+        }
+      (*i)->events = events;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t count = 1;
+  m_nodePartition.resize (NodeList::GetNNodes ());
+  for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      m_nodePartition[node->GetId ()] = node->GetSystemId ();
+      count = std::max (count, node->GetSystemId () + 1);
+    }
+#ifndef NS3_MULTITHREADED
+  if (count > 1)
+    {
+      NS_FATAL_ERROR ("Can't run more than one partition without the multithreaded simulator "
+                      "compiled in: configure with --enable-multithreaded-simulator");
+    }
+#endif
+  while (m_partitions.size () < count)
+    {
+      Partition *partition = new Partition ();
+      partition->id = m_partitions.size ();
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+      partition->uid = m_uid;
+      partition->currentUid = m_currentUid;
+      partition->currentTs = m_currentTs;
+      partition->currentContext = 0xffffffff;
+      partition->stop = false;
+      partition->stopped = false;
+      partition->next = MAX_TS;
+      partition->windowStart = m_currentTs;
+      m_partitions.push_back (partition);
+    }
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      (*i)->outbox.resize (m_partitions.size ());
+    }
+  delete m_barrier;
+  m_barrier = new PartitionBarrier (m_partitions.size ());
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lookAhead = MAX_TS;
+  for (uint32_t i = 0; i < ChannelList::GetNChannels (); ++i)
+    {
+      Ptr<Channel> channel = ChannelList::GetChannel (i);
+      if (channel->GetNDevices () == 0)
+        {
+          continue;
+        }
+      uint32_t partition = channel->GetDevice (0)->GetNode ()->GetSystemId ();
+      bool remote = false;
+      for (uint32_t j = 1; j < channel->GetNDevices (); ++j)
+        {
+          remote |= channel->GetDevice (j)->GetNode ()->GetSystemId () != partition;
+        }
+      if (!remote)
+        {
+          continue;
+        }
+      Time lookAhead = channel->GetLookAhead ();
+      if (lookAhead.GetTimeStep () <= 0)
+        {
+          NS_FATAL_ERROR ("Channel " << channel->GetId () << " links nodes of different partitions"
+                          " with no lookahead: the partitions can't run in parallel");
+        }
+      m_lookAhead = std::min<uint64_t> (m_lookAhead, lookAhead.GetTimeStep ());
+    }
+  NS_LOG_LOGIC ("lookahead " << m_lookAhead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context < m_nodePartition.size ())
+    {
+      return m_nodePartition[context];
+    }
+  // the events with no node context run in the first partition
+  return 0;
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  return static_cast<Partition *> (pthread_getspecific (g_currentPartition));
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitions.size ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  return TimeStep (m_lookAhead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      return partition->id;
+    }
+  return 0;
+}
+
+bool
+MultithreadedSimulatorImpl::IsBeforeStop (const Scheduler::EventKey &key) const
+{
+  return key.m_ts < m_stopTs || (key.m_ts == m_stopTs && key.m_uid < m_stopUid);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::NextTs (Partition *partition) const
+{
+  if (partition->events->IsEmpty () || partition->stop)
+    {
+      return MAX_TS;
+    }
+  Scheduler::Event next = partition->events->PeekNext ();
+  if (!IsBeforeStop (next.key))
+    {
+      return MAX_TS;
+    }
+  return next.key.m_ts;
+}
+
+void
+MultithreadedSimulatorImpl::Insert (Partition *partition, Scheduler::Event &ev)
+{
+  // the partitions allocate the uids in turn, so they are unique and
+  // increase in each partition
+  ev.key.m_uid = partition->uid;
+  partition->uid += m_partitions.size ();
+  partition->events->Insert (ev);
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveEvents (Partition *partition)
+{
+  // the senders are visited in the same order at each barrier, so the
+  // simultaneous events get the same uids whatever the thread timings
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      std::vector<Scheduler::Event> &inbox = (*i)->outbox[partition->id];
+      for (std::vector<Scheduler::Event>::iterator j = inbox.begin (); j != inbox.end (); j++)
+        {
+          Insert (partition, *j);
+        }
+      inbox.clear ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent (Partition *partition)
+{
+  Scheduler::Event next = partition->events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= partition->currentTs);
+
+  NS_LOG_LOGIC ("handle " << next.key.m_ts << " in partition " << partition->id);
+  partition->currentTs = next.key.m_ts;
+  partition->currentContext = next.key.m_context;
+  partition->currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (uint32_t id)
+{
+  Partition *partition = m_partitions[id];
+  pthread_setspecific (g_currentPartition, partition);
+  while (true)
+    {
+      ReceiveEvents (partition);
+      partition->next = NextTs (partition);
+      partition->stopped = partition->stop;
+      m_barrier->Wait ();
+
+      // the published values are not written again before the next
+      // barrier, so all the partitions take the same decision
+      uint64_t lbts = MAX_TS;
+      bool stop = false;
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+        {
+          lbts = std::min (lbts, (*i)->next);
+          stop |= (*i)->stopped;
+        }
+      if (stop || lbts == MAX_TS)
+        {
+          break;
+        }
+      partition->windowStart = lbts;
+      // no event can be received from another partition before granted
+      uint64_t granted = lbts + std::min (m_lookAhead, MAX_TS - lbts);
+      while (!partition->stop && !partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->PeekNext ();
+          if (next.key.m_ts >= granted || !IsBeforeStop (next.key))
+            {
+              break;
+            }
+          ProcessOneEvent (partition);
+        }
+      m_barrier->Wait ();
+    }
+  pthread_setspecific (g_currentPartition, 0);
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Run Thread-unsafe invocation!");
+  CreatePartitions ();
+  CalculateLookAhead ();
+
+  // hand the events scheduled out of the runs to their partitions
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event ev = m_events->RemoveNext ();
+      m_partitions[GetPartition (ev.key.m_context)]->events->Insert (ev);
+    }
+  uint32_t uid = m_uid;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      uid = std::max (uid, (*i)->uid);
+    }
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      (*i)->uid = uid + (*i)->id;
+      (*i)->windowStart = (*i)->currentTs;
+      (*i)->stop = false;
+    }
+  m_stop = false;
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (
+          MakeCallback (&MultithreadedSimulatorImpl::RunPartition, this).Bind (i));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+  RunPartition (0);
+  for (std::vector<Ptr<SystemThread> >::iterator i = threads.begin (); i != threads.end (); i++)
+    {
+      (*i)->Join ();
+    }
+
+  // the main thread goes on from the latest event run
+  Partition *last = m_partitions[0];
+  Partition *stopped = 0;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      m_uid = std::max (m_uid, (*i)->uid);
+      if ((*i)->currentTs > last->currentTs)
+        {
+          last = *i;
+        }
+      if ((*i)->stop && stopped == 0)
+        {
+          stopped = *i;
+        }
+    }
+  m_firstPendingUid = m_uid;
+  if (stopped != 0)
+    {
+      last = stopped;
+    }
+  else if (m_stopTs != MAX_TS)
+    {
+      // the stop time was reached: it is consumed, as the stop event
+      // of the DefaultSimulatorImpl
+      m_currentTs = m_stopTs;
+      m_currentUid = m_stopUid;
+      m_stopTs = MAX_TS;
+      return;
+    }
+  m_currentTs = last->currentTs;
+  m_currentUid = last->currentUid;
+  m_currentContext = last->currentContext;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  Partition *current = GetCurrentPartition ();
+  if (current != 0)
+    {
+      return current->events->IsEmpty () || current->stop;
+    }
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return m_events->IsEmpty ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      // the stop is published to the other partitions at the next
+      // barrier, so they stop at the end of the current window, before
+      // any event they could receive from this partition.
+      partition->stop = true;
+    }
+  else
+    {
+      m_stop = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      Simulator::Schedule (time, &Simulator::Stop);
+      if (m_lookAhead == MAX_TS)
+        {
+          // no channel links the partitions: they all stop at the barrier
+          return;
+        }
+      // the other partitions stop at the same time, or a lookahead from
+      // now if the time is sooner
+      uint64_t ts = partition->currentTs + std::max<uint64_t> (time.GetTimeStep (), m_lookAhead);
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
+        {
+          if (*i != partition)
+            {
+              Scheduler::Event ev;
+              ev.impl = MakeEvent (&Simulator::Stop);
+              ev.key.m_ts = ts;
+              ev.key.m_context = 0xffffffff;
+              partition->outbox[(*i)->id].push_back (ev);
+            }
+        }
+      return;
+    }
+  Time tAbsolute = time + TimeStep (m_currentTs);
+  NS_ASSERT (tAbsolute.IsPositive ());
+  uint64_t ts = tAbsolute.GetTimeStep ();
+  if (ts < m_stopTs)
+    {
+      // the events scheduled before the stop at the same time are run
+      m_stopTs = ts;
+      m_stopUid = m_uid;
+    }
+  m_uid++;
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  Scheduler::Event ev;
+  ev.impl = event;
+  if (partition != 0)
+    {
+      Time tAbsolute = time + TimeStep (partition->currentTs);
+      NS_ASSERT (tAbsolute.IsPositive ());
+      ev.key.m_ts = static_cast<uint64_t> (tAbsolute.GetTimeStep ());
+      ev.key.m_context = partition->currentContext;
+      Insert (partition, ev);
+    }
+  else
+    {
+      NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+      Time tAbsolute = time + TimeStep (m_currentTs);
+      NS_ASSERT (tAbsolute.IsPositive ());
+      ev.key.m_ts = static_cast<uint64_t> (tAbsolute.GetTimeStep ());
+      ev.key.m_context = m_currentContext;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_events->Insert (ev);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_context = context;
+  if (partition == 0)
+    {
+      NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleWithContext Thread-unsafe invocation!");
+      ev.key.m_ts = m_currentTs + time.GetTimeStep ();
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_events->Insert (ev);
+      return;
+    }
+  ev.key.m_ts = partition->currentTs + time.GetTimeStep ();
+  uint32_t destination = GetPartition (context);
+  if (destination == partition->id)
+    {
+      Insert (partition, ev);
+    }
+  else
+    {
+      NS_ASSERT_MSG (static_cast<uint64_t> (time.GetTimeStep ()) >= m_lookAhead,
+                     "Event scheduled in another partition sooner than the lookahead");
+      partition->outbox[destination].push_back (ev);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      return TimeStep (partition->currentTs);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0 && GetPartition (id.GetContext ()) != partition->id)
+    {
+      // the event may run in the thread of its partition meanwhile: it
+      // is removed there, a lookahead from now.
+      NS_ASSERT_MSG (m_lookAhead != MAX_TS, "Can't remove an event of a partition not linked to this one");
+      ScheduleWithContext (id.GetContext (), TimeStep (m_lookAhead),
+                           MakeEvent (&MultithreadedSimulatorImpl::Remove, this, id));
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  if (partition != 0)
+    {
+      partition->events->Remove (event);
+    }
+  else if (id.GetUid () >= m_firstPendingUid)
+    {
+      m_events->Remove (event);
+    }
+  else
+    {
+      m_partitions[GetPartition (id.GetContext ())]->events->Remove (event);
+    }
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0 && id.GetUid () != 2 && GetPartition (id.GetContext ()) != partition->id)
+    {
+      // as for Remove, the event is cancelled in the thread of its partition
+      NS_ASSERT_MSG (m_lookAhead != MAX_TS, "Can't cancel an event of a partition not linked to this one");
+      ScheduleWithContext (id.GetContext (), TimeStep (m_lookAhead),
+                           MakeEvent (&MultithreadedSimulatorImpl::Cancel, this, id));
+      return;
+    }
+  id.PeekEventImpl ()->Cancel ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0
+          || ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (ev.PeekEventImpl () == 0
+      || ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  // the event is compared with the clock of the partition which runs it,
+  // or with the clock of the main thread if it was scheduled out of the
+  // runs and not handed to its partition yet.
+  uint64_t currentTs = m_currentTs;
+  uint32_t currentUid = m_currentUid;
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0 || ev.GetUid () < m_firstPendingUid)
+    {
+      Partition *owner = m_partitions[GetPartition (ev.GetContext ())];
+      if (partition != 0 && owner != partition)
+        {
+          // the owner runs in another thread: its events are seen as of
+          // the start of the current window, which all the partitions
+          // have reached.
+          return ev.GetTs () < partition->windowStart;
+        }
+      currentTs = owner->currentTs;
+      currentUid = owner->currentUid;
+    }
+  if (ev.GetTs () < currentTs
+      || (ev.GetTs () == currentTs
+          && ev.GetUid () <= currentUid))
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  /// \todo I am fairly certain other compilers use other non-standard
+  /// post-fixes to indicate 64 bit constants.
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      return partition->currentContext;
+    }
+  return m_currentContext;
+}
+
+#endif /* WIN32 */
+} // namespace ns3
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+class PartitionBarrier;
+
+/**
+ * \ingroup simulator
+ * \ingroup mpi
+ *
+ * \brief a parallel simulator running the partitions of a simulation
+ * in the threads of a single process
+ *
+ * The nodes are partitioned by their system id, as for the
+ * DistributedSimulatorImpl, and the events of each partition are
+ * kept in a separate event queue, run by its own thread. The threads
+ * are synchronized by a conservative algorithm: at each barrier, the
+ * lower bound on the timestamp of the next event of any partition
+ * (LBTS) is computed, and each partition runs the events which are
+ * earlier than the LBTS plus the lookahead, the smallest
+ * Channel::GetLookAhead of the channels between two partitions, before
+ * it waits for the next barrier.
+ *
+ * The events scheduled for a node of another partition, such as the
+ * receptions at the end of a point-to-point link, are queued in an
+ * outbox of the sending partition, and moved to the event queue of
+ * the receiving partition at the next barrier. Since the partitions
+ * share the address space, the packets are passed by pointer instead
+ * of being serialized. The events received at the same time from
+ * several partitions are ordered the same way at each run, but not
+ * always as the DefaultSimulatorImpl would order them.
+ *
+ * The event uids are unique across the partitions, each of which
+ * allocates one uid out of the number of partitions. An event of
+ * another partition can't be removed or cancelled at once, since it
+ * may run meanwhile: the request is sent to its partition, where it
+ * takes effect a lookahead later, and IsExpired sees such an event as
+ * of the start of the current window. Simulator::Stop stops the other
+ * partitions at the end of the current window, and
+ * Simulator::Stop (Time) at the same time as the calling partition, or
+ * a lookahead from now if the time is sooner.
+ *
+ * The partitions may only be linked by channels with a non-zero
+ * lookahead, such as the point-to-point channels with a non-zero delay
+ * and the YansWifiChannel, and running more than one partition requires ns-3
+ * to be configured with --enable-multithreaded-simulator, which makes
+ * the reference counts and the packet buffers thread-safe.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \returns the number of partitions of the last run
+   */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * \returns the lookahead of the last run
+   */
+  Time GetLookAhead (void) const;
+
+private:
+  /**
+   * The events and the clock of a partition, which are only accessed
+   * by the thread running the partition while the simulation runs.
+   */
+  struct Partition
+  {
+    uint32_t id;
+    Ptr<Scheduler> events;
+    // the next uid of the partition, which allocates one uid out of the
+    // number of partitions
+    uint32_t uid;
+    uint32_t currentUid;
+    uint64_t currentTs;
+    uint32_t currentContext;
+    bool stop;
+    // the timestamp of the next event to run and the stop flag,
+    // published for the other partitions at the barriers
+    uint64_t next;
+    bool stopped;
+    // the LBTS of the current window: every partition ran its events
+    // before it
+    uint64_t windowStart;
+    // events scheduled for the other partitions during the current
+    // window, indexed by the receiving partition
+    std::vector<std::vector<Scheduler::Event> > outbox;
+  };
+
+  virtual void DoDispose (void);
+  void CalculateLookAhead (void);
+  void CreatePartitions (void);
+  uint32_t GetPartition (uint32_t context) const;
+  Partition *GetCurrentPartition (void) const;
+  void RunPartition (uint32_t id);
+  void ReceiveEvents (Partition *partition);
+  bool IsBeforeStop (const Scheduler::EventKey &key) const;
+  uint64_t NextTs (Partition *partition) const;
+  void ProcessOneEvent (Partition *partition);
+  void Insert (Partition *partition, Scheduler::Event &ev);
+
+  typedef std::list<EventId> DestroyEvents;
+
+  DestroyEvents m_destroyEvents;
+  mutable SystemMutex m_destroyEventsMutex;
+  ObjectFactory m_schedulerFactory;
+  // the events scheduled from the main thread out of the runs
+  Ptr<Scheduler> m_events;
+  std::vector<Partition *> m_partitions;
+  // the partition of each node, indexed by node id
+  std::vector<uint32_t> m_nodePartition;
+  PartitionBarrier *m_barrier;
+  uint64_t m_lookAhead;
+  // the events before this key are run, the next ones are not
+  uint64_t m_stopTs;
+  uint32_t m_stopUid;
+  bool m_stop;
+  uint32_t m_uid;
+  // the uids of the events of m_events are greater than or equal to this
+  uint32_t m_firstPendingUid;
+  uint32_t m_currentUid;
+  uint64_t m_currentTs;
+  uint32_t m_currentContext;
+  SystemThread::ThreadId m_main;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
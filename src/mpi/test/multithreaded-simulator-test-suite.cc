@@ -0,0 +1,545 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/nqos-wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Runs a simulation with the DefaultSimulatorImpl, then with the
+ * MultithreadedSimulatorImpl, and checks that each node sees the same
+ * events at the same times.
+ *
+ * The nodes are assigned to the partitions by blocks, and send packets
+ * to the next node, which forwards them a few times, so that the
+ * events of a partition depend on the packets received from the other
+ * ones. Both runs use the same system ids: the YansWifiChannel starts
+ * the receptions of another system id a lookahead late, which is part
+ * of the model being compared. With one partition, the
+ * runs are compared in the default build too.
+ *
+ * The events of a node which happen at the same time may be recorded
+ * in a different order, since the simultaneous events of two partitions
+ * are not ordered as in the DefaultSimulatorImpl, so they are compared
+ * sorted.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  enum Topology
+  {
+    POINT_TO_POINT,
+    YANS_WIFI
+  };
+
+  MultithreadedSimulatorTestCase (enum Topology topology, uint32_t partitions);
+
+private:
+  static std::string GetName (enum Topology topology, uint32_t partitions);
+  enum Kind
+  {
+    SEND,
+    RECEIVE,
+    PHY_TX_BEGIN,
+    PHY_RX_BEGIN,
+    PHY_RX_END,
+    PHY_RX_DROP
+  };
+  struct Record
+  {
+    uint64_t ts;
+    uint32_t kind;
+    uint32_t origin;
+    uint32_t seq;
+    uint32_t size;
+    bool operator < (const Record &o) const;
+    bool operator == (const Record &o) const;
+  };
+  typedef std::vector<std::vector<Record> > Records;
+
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  Records RunSimulation (std::string simulatorType);
+  NetDeviceContainer CreatePointToPoint (NodeContainer nodes);
+  NetDeviceContainer CreateYansWifi (NodeContainer nodes);
+  void Connect (Ptr<Object> phy, uint32_t node);
+  void Send (uint32_t node, uint32_t origin, uint32_t seq, uint32_t hops);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  void RecordPhy (uint32_t kind, uint32_t node, Ptr<const Packet> packet);
+  void AddRecord (uint32_t node, uint32_t kind, uint32_t origin, uint32_t seq, uint32_t size);
+
+  enum Topology m_topology;
+  uint32_t m_partitions;
+  // the device each node sends its packets on, and the destination
+  std::vector<Ptr<NetDevice> > m_devices;
+  std::vector<Address> m_destinations;
+  // the events of each node, only written by the thread of its partition
+  Records m_records;
+  uint32_t m_runPartitions;
+};
+
+static const uint32_t N_NODES = 8;
+static const uint32_t N_PACKETS = 20;
+static const uint32_t N_HOPS = 4;
+
+bool
+MultithreadedSimulatorTestCase::Record::operator < (const Record &o) const
+{
+  if (ts != o.ts)
+    {
+      return ts < o.ts;
+    }
+  if (kind != o.kind)
+    {
+      return kind < o.kind;
+    }
+  if (origin != o.origin)
+    {
+      return origin < o.origin;
+    }
+  if (seq != o.seq)
+    {
+      return seq < o.seq;
+    }
+  return size < o.size;
+}
+
+bool
+MultithreadedSimulatorTestCase::Record::operator == (const Record &o) const
+{
+  return ts == o.ts && kind == o.kind && origin == o.origin && seq == o.seq && size == o.size;
+}
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (enum Topology topology, uint32_t partitions)
+  : TestCase (GetName (topology, partitions)),
+    m_topology (topology),
+    m_partitions (partitions)
+{
+}
+
+std::string
+MultithreadedSimulatorTestCase::GetName (enum Topology topology, uint32_t partitions)
+{
+  std::ostringstream oss;
+  oss << (topology == POINT_TO_POINT ? "point-to-point" : "yans-wifi")
+      << " nodes in " << partitions << (partitions == 1 ? " partition" : " partitions");
+  return oss.str ();
+}
+
+void
+MultithreadedSimulatorTestCase::AddRecord (uint32_t node, uint32_t kind, uint32_t origin, uint32_t seq, uint32_t size)
+{
+  struct Record record;
+  record.ts = Simulator::Now ().GetTimeStep ();
+  record.kind = kind;
+  record.origin = origin;
+  record.seq = seq;
+  record.size = size;
+  m_records[node].push_back (record);
+}
+
+void
+MultithreadedSimulatorTestCase::RecordPhy (uint32_t kind, uint32_t node, Ptr<const Packet> packet)
+{
+  AddRecord (node, kind, 0, 0, packet->GetSize ());
+}
+
+void
+MultithreadedSimulatorTestCase::Send (uint32_t node, uint32_t origin, uint32_t seq, uint32_t hops)
+{
+  uint32_t data[3] = { origin, seq, hops };
+  // the sizes differ, so do the transmission times
+  uint32_t size = sizeof (data) + 100 + 20 * origin + seq;
+  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (data), sizeof (data));
+  packet->AddPaddingAtEnd (size - sizeof (data));
+  AddRecord (node, SEND, origin, seq, size);
+  m_devices[node]->Send (packet, m_destinations[node], 0x0800);
+}
+
+bool
+MultithreadedSimulatorTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                         uint16_t protocol, const Address &from)
+{
+  uint32_t node = device->GetNode ()->GetId ();
+  uint32_t data[3];
+  packet->CopyData (reinterpret_cast<uint8_t *> (data), sizeof (data));
+  AddRecord (node, RECEIVE, data[0], data[1], packet->GetSize ());
+  if (data[2] > 0)
+    {
+      Simulator::Schedule (MicroSeconds (10 + node), &MultithreadedSimulatorTestCase::Send, this,
+                           node, data[0], data[1], data[2] - 1);
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorTestCase::Connect (Ptr<Object> phy, uint32_t node)
+{
+  Callback<void, uint32_t, uint32_t, Ptr<const Packet> > cb = MakeCallback (&MultithreadedSimulatorTestCase::RecordPhy, this);
+  phy->TraceConnectWithoutContext ("PhyTxBegin", cb.Bind (uint32_t (PHY_TX_BEGIN)).Bind (node));
+  phy->TraceConnectWithoutContext ("PhyRxBegin", cb.Bind (uint32_t (PHY_RX_BEGIN)).Bind (node));
+  phy->TraceConnectWithoutContext ("PhyRxEnd", cb.Bind (uint32_t (PHY_RX_END)).Bind (node));
+  phy->TraceConnectWithoutContext ("PhyRxDrop", cb.Bind (uint32_t (PHY_RX_DROP)).Bind (node));
+}
+
+NetDeviceContainer
+MultithreadedSimulatorTestCase::CreatePointToPoint (NodeContainer nodes)
+{
+  // a ring, whose links have different delays
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      p2p.SetChannelAttribute ("Delay", TimeValue (MicroSeconds (1000 + 37 * i)));
+      NetDeviceContainer link = p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % N_NODES));
+      m_devices[i] = link.Get (0);
+      m_destinations[i] = link.Get (1)->GetAddress ();
+      Connect (link.Get (0), i);
+      Connect (link.Get (1), (i + 1) % N_NODES);
+      devices.Add (link);
+    }
+  return devices;
+}
+
+NetDeviceContainer
+MultithreadedSimulatorTestCase::CreateYansWifi (NodeContainer nodes)
+{
+  // no two paths of two hops from a node to another have the same
+  // length, give or take a meter, so the packets sent by two nodes at
+  // the end of the same busy period do not reach a node at once: the
+  // reception which would come first is not the same in both runs.
+  static const double xy[N_NODES][2] = {
+    { 0.0, 49.5 }, { 75.0, 43.5 }, { 36.0, 18.0 }, { 3.0, 45.0 },
+    { 55.5, 40.5 }, { 39.0, 58.5 }, { 27.0, 12.0 }, { 87.0, 4.5 }
+  };
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      positions->Add (Vector (xy[i][0], xy[i][1], 0.0));
+    }
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (nodes);
+
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  // the streams are not allocated again by the second run
+  wifi.AssignStreams (devices, 1);
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      m_devices[i] = devices.Get (i);
+      m_destinations[i] = devices.Get ((i + 1) % N_NODES)->GetAddress ();
+      Connect (DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy (), i);
+    }
+  return devices;
+}
+
+MultithreadedSimulatorTestCase::Records
+MultithreadedSimulatorTestCase::RunSimulation (std::string simulatorType)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  m_records.clear ();
+  m_records.resize (N_NODES);
+  m_devices.resize (N_NODES);
+  m_destinations.resize (N_NODES);
+
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      nodes.Add (CreateObject<Node> (i * m_partitions / N_NODES));
+    }
+  NetDeviceContainer devices;
+  if (m_topology == POINT_TO_POINT)
+    {
+      devices = CreatePointToPoint (nodes);
+    }
+  else
+    {
+      devices = CreateYansWifi (nodes);
+    }
+  for (uint32_t i = 0; i < devices.GetN (); ++i)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&MultithreadedSimulatorTestCase::Receive, this));
+    }
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      for (uint32_t j = 0; j < N_PACKETS; ++j)
+        {
+          Simulator::ScheduleWithContext (i, MilliSeconds (5 * j) + MicroSeconds (13 * i),
+                                          &MultithreadedSimulatorTestCase::Send, this,
+                                          i, i, j, N_HOPS);
+        }
+    }
+
+  Simulator::Run ();
+  m_runPartitions = 1;
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      m_runPartitions = impl->GetPartitionCount ();
+    }
+  Simulator::Destroy ();
+  m_devices.clear ();
+  m_destinations.clear ();
+
+  Records records = m_records;
+  m_records.clear ();
+  for (Records::iterator i = records.begin (); i != records.end (); i++)
+    {
+      std::stable_sort (i->begin (), i->end ());
+    }
+  return records;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  Records reference = RunSimulation ("ns3::DefaultSimulatorImpl");
+  Records parallel = RunSimulation ("ns3::MultithreadedSimulatorImpl");
+  NS_TEST_ASSERT_MSG_EQ (m_runPartitions, m_partitions, "the nodes did not run in their partitions");
+
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < N_NODES; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].size (), reference[i].size (), "node " << i << " saw another number of events");
+      for (uint32_t j = 0; j < reference[i].size (); ++j)
+        {
+          const struct Record &expected = reference[i][j];
+          const struct Record &got = parallel[i][j];
+          NS_TEST_ASSERT_MSG_EQ ((got == expected), true, "node " << i << " event " << j << " differs: kind " << got.kind
+                                 << " at " << got.ts << " instead of kind " << expected.kind << " at " << expected.ts);
+          received += expected.kind == RECEIVE && expected.origin != i;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (received, N_NODES * N_PACKETS, "too few packets were received to compare the runs");
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Checks the events of two nodes, in the same partition or in two
+ * partitions linked by a point-to-point channel with a delay of 1ms.
+ *
+ * The uids of the events scheduled by both nodes shall be unique. The
+ * first node removes, cancels and checks the events of the second one,
+ * which shall take effect as in the DefaultSimulatorImpl since they are
+ * a lookahead ahead. The first node then stops the simulation in 10ms,
+ * which shall stop both nodes at that time.
+ */
+class MultithreadedSimulatorEventTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorEventTestCase (uint32_t partitions);
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Record (uint32_t node, uint32_t tag);
+  void ScheduleEvents (uint32_t node);
+  void ScheduleTargets (uint32_t node);
+  void CheckExpired (uint32_t node, uint32_t target);
+  void Remove (uint32_t target);
+  void Cancel (uint32_t target);
+  static void Nothing (void);
+
+  uint32_t m_partitions;
+  // the records of each node, only written by the thread of its partition
+  std::vector<std::vector<uint32_t> > m_tags;
+  std::vector<std::vector<uint32_t> > m_uids;
+  std::vector<std::vector<bool> > m_expired;
+  // the events of the second node, written before the first node uses them
+  std::vector<EventId> m_targets;
+};
+
+MultithreadedSimulatorEventTestCase::MultithreadedSimulatorEventTestCase (uint32_t partitions)
+  : TestCase (partitions == 1 ? "events of the nodes of a partition" : "events of the nodes of two partitions"),
+    m_partitions (partitions)
+{
+}
+
+void
+MultithreadedSimulatorEventTestCase::Nothing (void)
+{
+}
+
+void
+MultithreadedSimulatorEventTestCase::Record (uint32_t node, uint32_t tag)
+{
+  m_tags[node].push_back (tag);
+}
+
+void
+MultithreadedSimulatorEventTestCase::ScheduleEvents (uint32_t node)
+{
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      EventId id = Simulator::Schedule (MicroSeconds (100 * i), &MultithreadedSimulatorEventTestCase::Nothing);
+      m_uids[node].push_back (id.GetUid ());
+    }
+}
+
+void
+MultithreadedSimulatorEventTestCase::ScheduleTargets (uint32_t node)
+{
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      EventId id = Simulator::Schedule (MilliSeconds (9 + 10 * i), &MultithreadedSimulatorEventTestCase::Record, this,
+                                        node, i + 1);
+      m_uids[node].push_back (id.GetUid ());
+      m_targets.push_back (id);
+    }
+}
+
+void
+MultithreadedSimulatorEventTestCase::CheckExpired (uint32_t node, uint32_t target)
+{
+  m_expired[node].push_back (Simulator::IsExpired (m_targets[target]));
+}
+
+void
+MultithreadedSimulatorEventTestCase::Remove (uint32_t target)
+{
+  Simulator::Remove (m_targets[target]);
+}
+
+void
+MultithreadedSimulatorEventTestCase::Cancel (uint32_t target)
+{
+  Simulator::Cancel (m_targets[target]);
+}
+
+void
+MultithreadedSimulatorEventTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  m_tags.resize (2);
+  m_uids.resize (2);
+  m_expired.resize (2);
+  NodeContainer nodes;
+  nodes.Add (CreateObject<Node> (0));
+  nodes.Add (CreateObject<Node> (m_partitions - 1));
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  p2p.Install (nodes);
+  uint32_t a = nodes.Get (0)->GetId ();
+  uint32_t b = nodes.Get (1)->GetId ();
+
+  // the targets of the second node run at 10ms, 20ms and 30ms
+  Simulator::ScheduleWithContext (b, MilliSeconds (1), &MultithreadedSimulatorEventTestCase::ScheduleTargets, this, 1);
+  Simulator::ScheduleWithContext (a, MilliSeconds (2), &MultithreadedSimulatorEventTestCase::ScheduleEvents, this, 0);
+  Simulator::ScheduleWithContext (b, MilliSeconds (2), &MultithreadedSimulatorEventTestCase::ScheduleEvents, this, 1);
+  Simulator::ScheduleWithContext (a, MilliSeconds (5), &MultithreadedSimulatorEventTestCase::Remove, this, 0);
+  Simulator::ScheduleWithContext (a, MilliSeconds (5), &MultithreadedSimulatorEventTestCase::Cancel, this, 1);
+  Simulator::ScheduleWithContext (a, MilliSeconds (15), &MultithreadedSimulatorEventTestCase::CheckExpired, this, 0, 2);
+  Simulator::ScheduleWithContext (a, MilliSeconds (35), &MultithreadedSimulatorEventTestCase::CheckExpired, this, 0, 2);
+  Simulator::ScheduleWithContext (a, MilliSeconds (40), &Simulator::Stop, MilliSeconds (10));
+  Simulator::ScheduleWithContext (b, MilliSeconds (45), &MultithreadedSimulatorEventTestCase::Record, this, 1, 4);
+  Simulator::ScheduleWithContext (b, MilliSeconds (55), &MultithreadedSimulatorEventTestCase::Record, this, 1, 5);
+  Simulator::ScheduleWithContext (a, MilliSeconds (55), &MultithreadedSimulatorEventTestCase::Record, this, 0, 6);
+  Simulator::Run ();
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "the simulator is not a MultithreadedSimulatorImpl");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetPartitionCount (), m_partitions, "the nodes did not run in their partitions");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (50), "the simulation did not stop at 50ms");
+  Simulator::Destroy ();
+
+  std::set<uint32_t> uids;
+  uids.insert (m_uids[0].begin (), m_uids[0].end ());
+  uids.insert (m_uids[1].begin (), m_uids[1].end ());
+  NS_TEST_EXPECT_MSG_EQ (uids.size (), m_uids[0].size () + m_uids[1].size (), "two events have the same uid");
+  NS_TEST_EXPECT_MSG_EQ (m_tags[0].size (), 0, "the first node ran an event after the stop");
+  NS_TEST_ASSERT_MSG_EQ (m_tags[1].size (), 2, "the second node did not run the events expected");
+  NS_TEST_EXPECT_MSG_EQ (m_tags[1][0], 3, "the removed or the cancelled event ran");
+  NS_TEST_EXPECT_MSG_EQ (m_tags[1][1], 4, "the event before the stop did not run");
+  NS_TEST_ASSERT_MSG_EQ (m_expired[0].size (), 2, "the events were not checked");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[0][0], false, "the pending event is expired");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[0][1], true, "the event run is not expired");
+}
+
+void
+MultithreadedSimulatorEventTestCase::DoTeardown (void)
+{
+  m_tags.clear ();
+  m_uids.clear ();
+  m_expired.clear ();
+  m_targets.clear ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ();
+};
+
+MultithreadedSimulatorTestSuite::MultithreadedSimulatorTestSuite ()
+  : TestSuite ("mpi-multithreaded-simulator", UNIT)
+{
+  AddTestCase (new MultithreadedSimulatorTestCase (MultithreadedSimulatorTestCase::POINT_TO_POINT, 1), TestCase::QUICK);
+  AddTestCase (new MultithreadedSimulatorTestCase (MultithreadedSimulatorTestCase::YANS_WIFI, 1), TestCase::QUICK);
+  AddTestCase (new MultithreadedSimulatorEventTestCase (1), TestCase::QUICK);
+#ifdef NS3_MULTITHREADED
+  // more than one partition shares the reference counts between threads
+  AddTestCase (new MultithreadedSimulatorTestCase (MultithreadedSimulatorTestCase::POINT_TO_POINT, 2), TestCase::QUICK);
+  AddTestCase (new MultithreadedSimulatorTestCase (MultithreadedSimulatorTestCase::POINT_TO_POINT, 4), TestCase::QUICK);
+  AddTestCase (new MultithreadedSimulatorTestCase (MultithreadedSimulatorTestCase::YANS_WIFI, 2), TestCase::QUICK);
+  AddTestCase (new MultithreadedSimulatorTestCase (MultithreadedSimulatorTestCase::YANS_WIFI, 4), TestCase::QUICK);
+  AddTestCase (new MultithreadedSimulatorEventTestCase (2), TestCase::QUICK);
+#endif
+}
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
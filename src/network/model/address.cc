@@ -295,6 +295,19 @@ std::istream& operator>> (std::istream& is, Address & address)
   return is;
 }
 
+size_t AddressHash::operator () (Address const &x) const
+{
+  uint8_t buf[Address::MAX_SIZE];
+  uint32_t len = x.CopyTo (buf);
 
+  // FNV-1a, cheap enough for the few bytes of an address
+  uint32_t hash = 2166136261U;
+  for (uint32_t i = 0; i < len; ++i)
+    {
+      hash ^= buf[i];
+      hash *= 16777619U;
+    }
+  return hash;
+}
 
 } // namespace ns3
@@ -27,6 +27,10 @@
 #include "ns3/attribute-helper.h"
 #include "ns3/tag-buffer.h"
 
+#ifdef WIN32
+#include <hash_map>
+#endif
+
 namespace ns3 {
 
 /**
@@ -232,6 +236,35 @@ bool operator < (const Address &a, const Address &b);
 std::ostream& operator<< (std::ostream& os, const Address & address);
 std::istream& operator>> (std::istream& is, Address & address);
 
+/**
+ * \class AddressHash
+ * \brief Hash function class for polymorphic addresses.
+ *
+ * The type of the address is not hashed because two addresses
+ * compare equal when one of their types is zero.
+ */
+#ifndef WIN32
+class AddressHash : public std::unary_function<Address, size_t>
+{
+public:
+  /**
+   * \brief Unary operator to hash an address.
+   * \param x address to hash
+   */
+  size_t operator () (Address const &x) const;
+};
+
+#else
+class AddressHash : public stdext::hash_compare<ns3::Address> {
+public:
+  size_t operator()(Address const &x) const;
+    bool operator() (const Address& s1, const Address& s2) const
+  {
+    return s1 < s2;
+  }
+
+};
+#endif
 
 } // namespace ns3
 
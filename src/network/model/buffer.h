@@ -24,8 +24,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
-
-#define noBUFFER_FREE_LIST 1
+#include "ns3/core-config.h"
 
 namespace ns3 {
 
@@ -612,17 +611,6 @@ private:
    * instance from the start of m_data->m_data
    */
   uint32_t m_end;
-
-#ifdef BUFFER_FREE_LIST
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize;
-  static FreeList *g_freeList;
-  static struct LocalStaticDestructor g_localStaticDestructor;
-#endif
 };
 
 } // namespace ns3
@@ -861,7 +849,11 @@ Buffer::Buffer (Buffer const&o)
     m_start (o.m_start),
     m_end (o.m_end)
 {
+#ifdef NS3_MULTITHREADED
+  __sync_add_and_fetch (&m_data->m_count, 1);
+#else
   m_data->m_count++;
+#endif
   NS_ASSERT (CheckInternalState ());
 }
 
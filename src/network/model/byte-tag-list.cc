@@ -18,14 +18,14 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "byte-tag-list.h"
+#include "packet-pool.h"
+#include "ns3/core-config.h"
 #include "ns3/log.h"
 #include <vector>
 #include <cstring>
 
 NS_LOG_COMPONENT_DEFINE ("ByteTagList");
 
-#define USE_FREE_LIST 1
-#define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (2147483647)
 
 namespace ns3 {
@@ -37,26 +37,6 @@ struct ByteTagListData {
   uint8_t data[4];
 };
 
-#ifdef USE_FREE_LIST
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
-{
-public:
-  ~ByteTagListDataFreeList ();
-} g_freeList;
-static uint32_t g_maxSize = 0;
-
-ByteTagListDataFreeList::~ByteTagListDataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (ByteTagListDataFreeList::iterator i = begin ();
-       i != end (); i++)
-    {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
-    }
-}
-#endif /* USE_FREE_LIST */
-
 ByteTagList::Iterator::Item::Item (TagBuffer buf_)
   : buf (buf_)
 {
@@ -135,7 +115,11 @@ ByteTagList::ByteTagList (const ByteTagList &o)
   NS_LOG_FUNCTION (this << &o);
   if (m_data != 0)
     {
+#ifdef NS3_MULTITHREADED
+      __sync_add_and_fetch (&m_data->count, 1);
+#else
       m_data->count++;
+#endif
     }
 }
 ByteTagList &
@@ -151,7 +135,11 @@ ByteTagList::operator = (const ByteTagList &o)
   m_used = o.m_used;
   if (m_data != 0)
     {
+#ifdef NS3_MULTITHREADED
+      __sync_add_and_fetch (&m_data->count, 1);
+#else
       m_data->count++;
+#endif
     }
   return *this;
 }
@@ -174,8 +162,13 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       m_data = Allocate (spaceNeeded);
       m_used = 0;
     } 
+#ifdef NS3_MULTITHREADED
+  // the other lists sharing the data may append in the same bytes
+  else if (m_data->size < spaceNeeded || m_data->count != 1)
+#else
   else if (m_data->size < spaceNeeded ||
            (m_data->count != 1 && m_data->dirty != m_used))
+#endif
     {
       struct ByteTagListData *newData = Allocate (spaceNeeded);
       std::memcpy (&newData->data, &m_data->data, m_used);
@@ -279,6 +272,11 @@ ByteTagList::AddAtEnd (int32_t adjustment, int32_t appendOffset)
       return;
     }
   ByteTagList list;
+  if (m_used > 0)
+    {
+      // the tags kept take no more room than the current ones
+      list.m_data = list.Allocate (m_used);
+    }
   ByteTagList::Iterator i = BeginAll ();
   while (i.HasNext ())
     {
@@ -313,6 +311,11 @@ ByteTagList::AddAtStart (int32_t adjustment, int32_t prependOffset)
       return;
     }
   ByteTagList list;
+  if (m_used > 0)
+    {
+      // the tags kept take no more room than the current ones
+      list.m_data = list.Allocate (m_used);
+    }
   ByteTagList::Iterator i = BeginAll ();
   while (i.HasNext ())
     {
@@ -338,30 +341,17 @@ ByteTagList::AddAtStart (int32_t adjustment, int32_t prependOffset)
   *this = list;
 }
 
-#ifdef USE_FREE_LIST
-
 struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
-    {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
-      NS_ASSERT (data != 0);
-      if (data->size >= size)
-        {
-          data->count = 1;
-          data->dirty = 0;
-          return data;
-        }
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
-    }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+  uint32_t capacity;
+  void *buffer = PacketPool::Allocate (PacketPool::BYTE_TAG_LIST,
+                                       size + sizeof (struct ByteTagListData) - 4, &capacity);
+  struct ByteTagListData *data = static_cast<struct ByteTagListData *> (buffer);
   data->count = 1;
-  data->size = size;
+  // the bytes rounded up by the pool are usable too
+  data->size = capacity - sizeof (struct ByteTagListData) + 4;
   data->dirty = 0;
   return data;
 }
@@ -374,54 +364,17 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  g_maxSize = std::max (g_maxSize, data->size);
+#ifdef NS3_MULTITHREADED
+  if (__sync_sub_and_fetch (&data->count, 1) == 0)
+#else
   data->count--;
   if (data->count == 0)
+#endif
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
-          data->size < g_maxSize)
-        {
-          uint8_t *buffer = (uint8_t *)data;
-          delete [] buffer;
-        }
-      else
-        {
-          g_freeList.push_back (data);
-        }
+      PacketPool::Deallocate (PacketPool::BYTE_TAG_LIST, data,
+                              data->size + sizeof (struct ByteTagListData) - 4);
     }
 }
 
-#else /* USE_FREE_LIST */
-
-struct ByteTagListData *
-ByteTagList::Allocate (uint32_t size)
-{
-  NS_LOG_FUNCTION (this << size);
-  uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
-  data->count = 1;
-  data->size = size;
-  data->dirty = 0;
-  return data;
-}
-
-void 
-ByteTagList::Deallocate (struct ByteTagListData *data)
-{
-  NS_LOG_FUNCTION (this << data);
-  if (data == 0)
-    {
-      return;
-    }
-  data->count--;
-  if (data->count == 0)
-    {
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
-    }
-}
-
-#endif /* USE_FREE_LIST */
-
 
 } // namespace ns3
@@ -61,4 +61,11 @@ Channel::GetId (void) const
   return m_id;
 }
 
+Time
+Channel::GetLookAhead (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return Seconds (0);
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -70,6 +71,18 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const = 0;
 
+  /**
+   * \returns the smallest delay between the start of a transmission on
+   * this channel and the first event it schedules on a node of another
+   * system id, or zero if the nodes of this channel may not be split
+   * across system ids.
+   *
+   * The parallel simulators run the partitions of the simulation
+   * independently during this delay. The default implementation
+   * returns zero.
+   */
+  virtual Time GetLookAhead (void) const;
+
 private:
   uint32_t m_id; // Channel id for this channel
 };
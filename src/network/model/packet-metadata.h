@@ -297,13 +297,6 @@ private:
     uint64_t packetUid;
   };
 
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -340,7 +333,6 @@ public:
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList;
   static bool m_enable;
   static bool m_enableChecking;
 
@@ -390,7 +382,11 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
 {
   NS_ASSERT (m_data != 0);
   NS_ASSERT (m_data->m_count < std::numeric_limits<uint32_t>::max());
+#ifdef NS3_MULTITHREADED
+  __sync_add_and_fetch (&m_data->m_count, 1);
+#else
   m_data->m_count++;
+#endif
 }
 PacketMetadata &
 PacketMetadata::operator = (PacketMetadata const& o)
@@ -399,14 +395,22 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
+#ifdef NS3_MULTITHREADED
+      if (__sync_sub_and_fetch (&m_data->m_count, 1) == 0)
+#else
       m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (m_data->m_count == 0)
+#endif
         {
           PacketMetadata::Recycle (m_data);
         }
       m_data = o.m_data;
       NS_ASSERT (m_data != 0);
+#ifdef NS3_MULTITHREADED
+      __sync_add_and_fetch (&m_data->m_count, 1);
+#else
       m_data->m_count++;
+#endif
     }
   m_head = o.m_head;
   m_tail = o.m_tail;
@@ -417,8 +421,12 @@ PacketMetadata::operator = (PacketMetadata const& o)
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
+#ifdef NS3_MULTITHREADED
+  if (__sync_sub_and_fetch (&m_data->m_count, 1) == 0)
+#else
   m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (m_data->m_count == 0)
+#endif
     {
       PacketMetadata::Recycle (m_data);
     }
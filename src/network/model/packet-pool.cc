@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-pool.h"
+#include "ns3/assert.h"
+#include "ns3/free-list-pool.h"
+
+#include <new>
+
+namespace ns3 {
+
+// the smallest block is 1 << PACKET_POOL_MIN_SHIFT bytes, and the blocks
+// larger than 1 << PACKET_POOL_MAX_SHIFT bytes are not pooled
+static const uint32_t PACKET_POOL_MIN_SHIFT = 4;
+static const uint32_t PACKET_POOL_MAX_SHIFT = 16;
+static const uint32_t PACKET_POOL_CLASSES = PACKET_POOL_MAX_SHIFT - PACKET_POOL_MIN_SHIFT + 1;
+// the bytes of free blocks kept per size class, beyond which they are
+// given back to the system allocator
+static const uint32_t PACKET_POOL_MAX_FREE_BYTES = 1 << 20;
+
+/**
+ * The counters of the blocks of a thread. The counters of the bytes in
+ * use may be negative when the blocks are deallocated by another thread
+ * than the one which allocated them.
+ */
+struct PacketPoolCounters
+{
+  uint64_t allocations[PacketPool::KINDS];
+  uint64_t poolHits[PacketPool::KINDS];
+  int64_t bytesInUse[PacketPool::KINDS];
+};
+
+typedef FreeListPool<struct PacketPoolCounters, PACKET_POOL_CLASSES> PacketPoolThreads;
+
+/**
+ * \param size the size of a block
+ * \returns the size class of the smallest power of two not below size,
+ * or PACKET_POOL_CLASSES if size is too large to be pooled.
+ */
+static uint32_t
+GetSizeClass (uint32_t size)
+{
+  uint32_t sizeClass = 0;
+  while (sizeClass < PACKET_POOL_CLASSES
+         && (1U << (sizeClass + PACKET_POOL_MIN_SHIFT)) < size)
+    {
+      sizeClass++;
+    }
+  return sizeClass;
+}
+
+void *
+PacketPool::Allocate (enum Kind kind, uint32_t size, uint32_t *capacity)
+{
+  NS_ASSERT (kind < KINDS);
+  PacketPoolThreads::Thread *pool = PacketPoolThreads::Get ();
+  uint32_t sizeClass = GetSizeClass (size);
+  *capacity = sizeClass < PACKET_POOL_CLASSES ? 1U << (sizeClass + PACKET_POOL_MIN_SHIFT) : size;
+  pool->counters.allocations[kind]++;
+  pool->counters.bytesInUse[kind] += *capacity;
+  void *p = 0;
+  if (sizeClass < PACKET_POOL_CLASSES)
+    {
+      p = PacketPoolThreads::Pop (pool, sizeClass);
+    }
+  if (p == 0)
+    {
+      return ::operator new (*capacity);
+    }
+  pool->counters.poolHits[kind]++;
+  return p;
+}
+
+void
+PacketPool::Deallocate (enum Kind kind, void *block, uint32_t capacity)
+{
+  NS_ASSERT (kind < KINDS);
+  PacketPoolThreads::Thread *pool = PacketPoolThreads::Get ();
+  pool->counters.bytesInUse[kind] -= capacity;
+  uint32_t sizeClass = GetSizeClass (capacity);
+  if (sizeClass == PACKET_POOL_CLASSES
+      || (1U << (sizeClass + PACKET_POOL_MIN_SHIFT)) != capacity
+      || (pool->nFree[sizeClass] + 1) * capacity > PACKET_POOL_MAX_FREE_BYTES)
+    {
+      ::operator delete (block);
+      return;
+    }
+  PacketPoolThreads::Push (pool, sizeClass, block);
+}
+
+struct PacketStats
+PacketPool::GetStats (enum Kind kind)
+{
+  NS_ASSERT (kind < KINDS);
+  struct PacketStats stats;
+  stats.allocations = 0;
+  stats.poolHits = 0;
+  int64_t bytesInUse = 0;
+  for (PacketPoolThreads::Thread *pool = PacketPoolThreads::GetThreads (); pool != 0; pool = pool->next)
+    {
+      stats.allocations += pool->counters.allocations[kind];
+      stats.poolHits += pool->counters.poolHits[kind];
+      bytesInUse += pool->counters.bytesInUse[kind];
+    }
+  stats.bytesInUse = bytesInUse;
+  return stats;
+}
+
+uint64_t
+PacketPool::GetPooledBytes (void)
+{
+  uint64_t pooled = 0;
+  for (PacketPoolThreads::Thread *pool = PacketPoolThreads::GetThreads (); pool != 0; pool = pool->next)
+    {
+      for (uint32_t i = 0; i < PACKET_POOL_CLASSES; i++)
+        {
+          pooled += uint64_t (pool->nFree[i]) << (i + PACKET_POOL_MIN_SHIFT);
+        }
+    }
+  return pooled;
+}
+
+} // namespace ns3
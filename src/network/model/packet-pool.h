@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief The counters of the memory blocks of one kind, see PacketPool.
+ */
+struct PacketStats
+{
+  /// the number of blocks allocated
+  uint64_t allocations;
+  /// the number of blocks allocated from a pool rather than by the system allocator
+  uint64_t poolHits;
+  /// the bytes of the blocks allocated and not deallocated yet
+  uint64_t bytesInUse;
+};
+
+/**
+ * \ingroup packet
+ *
+ * \brief The memory pools of the byte buffers, the metadata and the
+ * byte tag lists of the packets.
+ *
+ * The sizes of the blocks are rounded up to a power of two, from 16
+ * bytes to 64 KiB, and the deallocated blocks are kept by the thread
+ * which deallocated them, in a free list per power of two. Each free
+ * list keeps up to 1 MiB of blocks, beyond which the blocks are given
+ * back to the system allocator, as are the blocks larger than 64 KiB.
+ * A block allocated by one thread may be deallocated by another one.
+ *
+ * The counters are global: they are summed over the threads when they
+ * are queried.
+ */
+class PacketPool
+{
+public:
+  /**
+   * The structures whose blocks are counted apart.
+   */
+  enum Kind
+  {
+    BUFFER = 0,
+    METADATA,
+    BYTE_TAG_LIST,
+    KINDS
+  };
+
+  /**
+   * \param kind the structure which the block is allocated for
+   * \param size the minimum size of the block, in bytes
+   * \param capacity the size of the block returned, at least size
+   * \returns the block allocated
+   */
+  static void *Allocate (enum Kind kind, uint32_t size, uint32_t *capacity);
+  /**
+   * \param kind the structure which the block was allocated for
+   * \param block the block to deallocate
+   * \param capacity the capacity of the block returned by Allocate
+   */
+  static void Deallocate (enum Kind kind, void *block, uint32_t capacity);
+
+  /**
+   * \param kind the structure whose blocks are counted
+   * \returns the counters of the blocks allocated for kind by all the threads
+   */
+  static struct PacketStats GetStats (enum Kind kind);
+  /**
+   * \returns the bytes of the deallocated blocks which are kept for reuse
+   */
+  static uint64_t GetPooledBytes (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_POOL_H */
@@ -132,13 +132,17 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
     {
       NS_ASSERT (cur != 0);
       NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
       struct TagData * copy = new struct TagData ();
       copy->tid = cur->tid;
       copy->count = 1;
       memcpy (copy->data, cur->data, TagData::MAX_SIZE);
       copy->next = cur->next;             // merge into tail
+#ifdef NS3_MULTITHREADED
+      __sync_add_and_fetch (&copy->next->count, 1);
+#else
       copy->next->count++;                // mark new merge
+#endif
+      Unmerge (cur);                      // unmerge cur
       *prevNext = copy;                   // point prior list at copy
       prevNext = &copy->next;             // advance
       cur      =  copy->next;
@@ -182,13 +186,17 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   else
     {
       // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
       if (cur->next != 0)
         {
           // there's a next, so make it a merge
+#ifdef NS3_MULTITHREADED
+          __sync_add_and_fetch (&cur->next->count, 1);
+#else
           cur->next->count++;
+#endif
         }
+      // unmerge cur, since we linked around it already
+      Unmerge (cur);
     }
   return found;
 }
@@ -224,7 +232,6 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
     {
       // cur is always a merge at this point
       // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
       struct TagData * copy = new struct TagData ();
       copy->tid = tag.GetInstanceTypeId ();
       copy->count = 1;
@@ -233,13 +240,37 @@ PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
       copy->next = cur->next;           // merge into tail
       if (copy->next != 0)
         {
+#ifdef NS3_MULTITHREADED
+          __sync_add_and_fetch (&copy->next->count, 1);
+#else
           copy->next->count++;          // mark new merge
+#endif
         }
+      Unmerge (cur);                    // unmerge cur
       *prevNext = copy;                 // point prior list at copy
     }
   return found;
 }
 
+void
+PacketTagList::Unmerge (struct PacketTagList::TagData * cur)
+{
+#ifdef NS3_MULTITHREADED
+  if (__sync_sub_and_fetch (&cur->count, 1) == 0)
+    {
+      // the lists which shared cur are gone: release its link to the tail,
+      // which the caller holds another link to
+      if (cur->next != 0)
+        {
+          __sync_sub_and_fetch (&cur->next->count, 1);
+        }
+      delete cur;
+    }
+#else
+  cur->count--;
+#endif
+}
+
 void 
 PacketTagList::Add (const Tag &tag) const
 {
@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "ns3/core-config.h"
 
 namespace ns3 {
 
@@ -285,6 +286,17 @@ private:
    * \returns True, since tag value will definitely be replaced.
    */
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
+  /**
+   * Drop one incoming link of a merge, after its next node was
+   * marked as a merge for the copy replacing it.
+   *
+   * With NS3_MULTITHREADED, the other lists sharing \pname{cur} may
+   * have dropped their links meanwhile, in which case \pname{cur} is
+   * deleted here.
+   *
+   * \param [in] cur Pointer to the merge.
+   */
+  static void Unmerge (struct TagData * cur);
 
   /**
    * Pointer to first #struct TagData on the list
@@ -310,7 +322,11 @@ PacketTagList::PacketTagList (PacketTagList const &o)
 {
   if (m_next != 0)
     {
+#ifdef NS3_MULTITHREADED
+      __sync_add_and_fetch (&m_next->count, 1);
+#else
       m_next->count++;
+#endif
     }
 }
 
@@ -326,7 +342,11 @@ PacketTagList::operator = (PacketTagList const &o)
   m_next = o.m_next;
   if (m_next != 0) 
     {
+#ifdef NS3_MULTITHREADED
+      __sync_add_and_fetch (&m_next->count, 1);
+#else
       m_next->count++;
+#endif
     }
   return *this;
 }
@@ -342,8 +362,12 @@ PacketTagList::RemoveAll (void)
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
+#ifdef NS3_MULTITHREADED
+      if (__sync_sub_and_fetch (&cur->count, 1) > 0)
+#else
       cur->count--;
       if (cur->count > 0) 
+#endif
         {
           break;
         }
@@ -19,6 +19,7 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/packet-pool.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
@@ -716,6 +717,79 @@ PacketTagListTest::DoRun (void)
     
 }
 
+//--------------------------------------
+class PacketPoolTest : public TestCase
+{
+public:
+  PacketPoolTest ();
+private:
+  void DoRun (void);
+  void SendCopies (void);
+};
+
+PacketPoolTest::PacketPoolTest ()
+  : TestCase ("PacketPool")
+{
+}
+
+void
+PacketPoolTest::SendCopies (void)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  p->AddByteTag (ATestTag<20> ());
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<Packet> copy = p->Copy ();
+      copy->AddHeader (ATestHeader<10> ());
+      copy->AddByteTag (ATestTag<2> ());
+    }
+}
+
+void
+PacketPoolTest::DoRun (void)
+{
+  PacketPool::Kind kinds[] = { PacketPool::BUFFER, PacketPool::METADATA, PacketPool::BYTE_TAG_LIST };
+  struct PacketStats before[PacketPool::KINDS];
+  for (uint32_t k = 0; k < PacketPool::KINDS; k++)
+    {
+      before[kinds[k]] = PacketPool::GetStats (kinds[k]);
+    }
+  {
+    Ptr<Packet> p = Create<Packet> (1000);
+    p->AddByteTag (ATestTag<20> ());
+    for (uint32_t k = 0; k < PacketPool::KINDS; k++)
+      {
+        struct PacketStats stats = PacketPool::GetStats (kinds[k]);
+        NS_TEST_EXPECT_MSG_GT (stats.allocations, before[kinds[k]].allocations, "no block allocated");
+        NS_TEST_EXPECT_MSG_GT (stats.bytesInUse, before[kinds[k]].bytesInUse, "no bytes in use");
+      }
+  }
+  for (uint32_t k = 0; k < PacketPool::KINDS; k++)
+    {
+      struct PacketStats stats = PacketPool::GetStats (kinds[k]);
+      NS_TEST_EXPECT_MSG_EQ (stats.bytesInUse, before[kinds[k]].bytesInUse, "blocks leaked");
+      before[kinds[k]] = stats;
+    }
+  NS_TEST_EXPECT_MSG_GT (PacketPool::GetPooledBytes (), 0, "the blocks were not kept");
+
+  // the blocks of the copies are all allocated from the pools the
+  // second time
+  SendCopies ();
+  for (uint32_t k = 0; k < PacketPool::KINDS; k++)
+    {
+      before[kinds[k]] = PacketPool::GetStats (kinds[k]);
+    }
+  SendCopies ();
+  for (uint32_t k = 0; k < PacketPool::KINDS; k++)
+    {
+      struct PacketStats stats = PacketPool::GetStats (kinds[k]);
+      uint64_t allocations = stats.allocations - before[kinds[k]].allocations;
+      NS_TEST_EXPECT_MSG_GT (allocations, 0, "no block allocated");
+      NS_TEST_EXPECT_MSG_EQ (stats.poolHits - before[kinds[k]].poolHits, allocations, "blocks not reused");
+      NS_TEST_EXPECT_MSG_EQ (stats.bytesInUse, before[kinds[k]].bytesInUse, "blocks leaked");
+    }
+}
+
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
 {
@@ -728,6 +802,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketPoolTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite;
@@ -93,9 +93,17 @@ PointToPointChannel::TransmitStart (
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+#ifdef NS3_MULTITHREADED
+  // the receiver may run in another thread while the sender still
+  // holds p: give it its own packet, which shares the buffers of p
+  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+                                  txTime + m_delay, &PointToPointNetDevice::Receive,
+                                  m_link[wire].m_dst, p->Copy ());
+#else
   Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p);
+#endif
 
   // Call the tx anim callback on the net device
   m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
@@ -130,6 +138,12 @@ PointToPointChannel::GetDelay (void) const
   return m_delay;
 }
 
+Time
+PointToPointChannel::GetLookAhead (void) const
+{
+  return m_delay;
+}
+
 Ptr<PointToPointNetDevice>
 PointToPointChannel::GetSource (uint32_t i) const
 {
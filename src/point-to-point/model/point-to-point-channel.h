@@ -92,6 +92,12 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
 
+  /**
+   * \returns the propagation delay of the channel, after which a
+   * transmission is received by the other end of the link.
+   */
+  virtual Time GetLookAhead (void) const;
+
 protected:
   /*
    * \brief Get the delay associated with this channel
@@ -21,7 +21,12 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
+#include "ns3/callback.h"
+#include "ns3/assert.h"
+#include <algorithm>
 #include <map>
+#include <vector>
+#include <stdint.h>
 
 namespace ns3
 {
@@ -30,60 +35,200 @@ namespace ns3
  * \brief Constructs a cache of objects, where each obect is responsible for a single propagation path loss calculations.
  * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
  * a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are kept in an open-addressing hash table, keyed by the
+ * pointers of the two mobility models in ascending order and by the
+ * model uid, so a lookup takes a constant time. The paths of a mobility
+ * model are evicted when it is disposed, which releases the references
+ * of the cache to the mobility model and to the objects of its paths,
+ * and to the mobility models at the other end of its paths which are
+ * left without any path.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
-  ~PropagationCache () {};
+  PropagationCache ()
+    : m_size (0)
+  {};
+  ~PropagationCache ()
+  {
+    for (typename Models::iterator i = m_models.begin (); i != m_models.end (); i++)
+      {
+        ConstCast<MobilityModel> (i->second.mobility)
+          ->TraceDisconnectWithoutContext ("Dispose", MakeCallback (&PropagationCache<T>::Evict, this));
+      }
+  };
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
-    if (it == m_pathCache.end ())
+    if (m_size == 0)
       {
         return 0;
       }
-    return it->second;
+    return m_table[Find (PeekPointer (a), PeekPointer (b), modelUid)].data;
   };
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    NS_ASSERT (data != 0);
+    if (2 * (m_size + 1) > m_table.size ())
+      {
+        Resize (m_table.empty () ? 64 : 2 * m_table.size ());
+      }
+    PropagationPath &path = m_table[Find (PeekPointer (a), PeekPointer (b), modelUid)];
+    NS_ASSERT (path.data == 0);
+    path.low = std::min (PeekPointer (a), PeekPointer (b));
+    path.high = std::max (PeekPointer (a), PeekPointer (b));
+    path.modelUid = modelUid;
+    path.data = data;
+    m_size++;
+    Track (a, PeekPointer (b), modelUid);
+    if (a != b)
+      {
+        Track (b, PeekPointer (a), modelUid);
+      }
   };
 private:
-  /// Each path is identified by
-  struct PropagationPathIdentifier
+  /// Each path is identified by the mobility models of its ends, in ascending order, and a model uid
+  struct PropagationPath
   {
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
-    {};
-    Ptr<const MobilityModel> m_srcMobility;
-    Ptr<const MobilityModel> m_dstMobility;
-    uint32_t m_spectrumModelUid;
-    bool operator < (const PropagationPathIdentifier & other) const
-    {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
-    }
+    PropagationPath () : low (0), high (0), modelUid (0) {};
+    const MobilityModel *low;
+    const MobilityModel *high;
+    uint32_t modelUid;
+    // zero for the free entries of the table
+    Ptr<T> data;
   };
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
-  PathCache m_pathCache;
+  /// The mobility models with paths in the cache, and the other end of their paths
+  struct Model
+  {
+    Ptr<const MobilityModel> mobility;
+    std::vector<std::pair<const MobilityModel *, uint32_t> > paths;
+  };
+  typedef std::map<const MobilityModel *, Model> Models;
+
+  uint32_t Hash (const MobilityModel *low, const MobilityModel *high, uint32_t modelUid) const
+  {
+    uint64_t h = reinterpret_cast<uintptr_t> (low) * 0x9e3779b97f4a7c15ULL;
+    h ^= reinterpret_cast<uintptr_t> (high) + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2);
+    h ^= modelUid * 0x9e3779b1U;
+    return static_cast<uint32_t> (h ^ (h >> 32)) & (m_table.size () - 1);
+  };
+  /**
+   * \returns the index of the entry of the path, or of the free entry
+   * where the path would be inserted if it is not in the table.
+   */
+  uint32_t Find (const MobilityModel *a, const MobilityModel *b, uint32_t modelUid) const
+  {
+    const MobilityModel *low = std::min (a, b);
+    const MobilityModel *high = std::max (a, b);
+    uint32_t mask = m_table.size () - 1;
+    uint32_t i = Hash (low, high, modelUid);
+    while (m_table[i].data != 0
+           && (m_table[i].low != low || m_table[i].high != high || m_table[i].modelUid != modelUid))
+      {
+        i = (i + 1) & mask;
+      }
+    return i;
+  };
+  void Resize (uint32_t size)
+  {
+    std::vector<PropagationPath> table (size);
+    table.swap (m_table);
+    for (typename std::vector<PropagationPath>::const_iterator i = table.begin (); i != table.end (); i++)
+      {
+        if (i->data != 0)
+          {
+            m_table[Find (i->low, i->high, i->modelUid)] = *i;
+          }
+      }
+  };
+  void Track (Ptr<const MobilityModel> mobility, const MobilityModel *other, uint32_t modelUid)
+  {
+    typename Models::iterator i = m_models.find (PeekPointer (mobility));
+    if (i == m_models.end ())
+      {
+        i = m_models.insert (std::make_pair (PeekPointer (mobility), Model ())).first;
+        i->second.mobility = mobility;
+        ConstCast<MobilityModel> (mobility)
+          ->TraceConnectWithoutContext ("Dispose", MakeCallback (&PropagationCache<T>::Evict, this));
+      }
+    i->second.paths.push_back (std::make_pair (other, modelUid));
+  };
+  /**
+   * Remove a path from the table, and move back the paths which follow
+   * it in its probe sequence, so the lookups never need to skip removed
+   * entries.
+   */
+  void Remove (const MobilityModel *a, const MobilityModel *b, uint32_t modelUid)
+  {
+    uint32_t mask = m_table.size () - 1;
+    uint32_t i = Find (a, b, modelUid);
+    if (m_table[i].data == 0)
+      {
+        return;
+      }
+    m_table[i] = PropagationPath ();
+    m_size--;
+    for (uint32_t j = (i + 1) & mask; m_table[j].data != 0; j = (j + 1) & mask)
+      {
+        uint32_t home = Hash (m_table[j].low, m_table[j].high, m_table[j].modelUid);
+        // move the path of entry j back to the free entry i, unless its
+        // home entry lies cyclically in (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask))
+          {
+            m_table[i] = m_table[j];
+            m_table[j] = PropagationPath ();
+            i = j;
+          }
+      }
+  };
+  /**
+   * Evict the paths of a mobility model, when it is disposed, and forget
+   * the mobility models left without any path.
+   */
+  void Evict (Ptr<const MobilityModel> mobility)
+  {
+    typename Models::iterator i = m_models.find (PeekPointer (mobility));
+    if (i == m_models.end ())
+      {
+        return;
+      }
+    for (typename std::vector<std::pair<const MobilityModel *, uint32_t> >::const_iterator j = i->second.paths.begin ();
+         j != i->second.paths.end (); j++)
+      {
+        Remove (PeekPointer (mobility), j->first, j->second);
+        if (j->first != PeekPointer (mobility))
+          {
+            Untrack (j->first, PeekPointer (mobility), j->second);
+          }
+      }
+    m_models.erase (i);
+  };
+  /**
+   * Remove the path to other from the paths of a mobility model, and
+   * the mobility model itself if it has no path left.
+   */
+  void Untrack (const MobilityModel *mobility, const MobilityModel *other, uint32_t modelUid)
+  {
+    typename Models::iterator i = m_models.find (mobility);
+    NS_ASSERT (i != m_models.end ());
+    std::vector<std::pair<const MobilityModel *, uint32_t> > &paths = i->second.paths;
+    typename std::vector<std::pair<const MobilityModel *, uint32_t> >::iterator j =
+      std::find (paths.begin (), paths.end (), std::make_pair (other, modelUid));
+    NS_ASSERT (j != paths.end ());
+    *j = paths.back ();
+    paths.pop_back ();
+    if (paths.empty ())
+      {
+        ConstCast<MobilityModel> (i->second.mobility)
+          ->TraceDisconnectWithoutContext ("Dispose", MakeCallback (&PropagationCache<T>::Evict, this));
+        m_models.erase (i);
+      }
+  };
+
+  std::vector<PropagationPath> m_table;
+  uint32_t m_size;
+  Models m_models;
 };
 } // namespace ns3
 
@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-cache.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +437,97 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+  virtual ~PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Test PropagationCache")
+{
+}
+
+PropagationCacheTestCase::~PropagationCacheTestCase ()
+{
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  // enough paths for the table to grow a few times
+  const uint32_t n = 40;
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  PropagationCache<Object> cache;
+  std::vector<Ptr<Object> > paths;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 1; j < n; j++)
+        {
+          paths.push_back (CreateObject<Object> ());
+          cache.AddPathData (paths.back (), mobility[i], mobility[j], 0);
+        }
+    }
+  Ptr<Object> other = CreateObject<Object> ();
+  cache.AddPathData (other, mobility[0], mobility[1], 1);
+
+  uint32_t k = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 1; j < n; j++, k++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[i], mobility[j], 0), paths[k], "Got the wrong path");
+          NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[j], mobility[i], 0), paths[k], "The paths shall be symmetrical");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[1], mobility[0], 1), other, "Got the wrong path for the other model uid");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[0], mobility[2], 1), 0, "Got a path which was never added");
+
+  // the paths of a disposed mobility model are evicted, the other ones are kept
+  mobility[1]->Dispose ();
+  k = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 1; j < n; j++, k++)
+        {
+          if (i == 1 || j == 1)
+            {
+              NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[i], mobility[j], 0), 0, "The path was not evicted");
+              NS_TEST_ASSERT_MSG_EQ (paths[k]->GetReferenceCount (), 1, "The cache still holds the evicted path");
+            }
+          else
+            {
+              NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[i], mobility[j], 0), paths[k], "Lost a path on eviction");
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (mobility[0], mobility[1], 1), 0, "The path of the other model uid was not evicted");
+
+  // a mobility model whose peers are all disposed is released
+  Ptr<MobilityModel> rsu = CreateObject<ConstantPositionMobilityModel> ();
+  for (uint32_t i = 2; i < n; i++)
+    {
+      cache.AddPathData (CreateObject<Object> (), rsu, mobility[i], 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (rsu->GetReferenceCount (), 2, "The cache shall hold the mobility model of its paths");
+  for (uint32_t i = 2; i < n - 1; i++)
+    {
+      mobility[i]->Dispose ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (rsu->GetReferenceCount (), 2, "The mobility model still has a path");
+  NS_TEST_ASSERT_MSG_NE (cache.GetPathData (rsu, mobility[n - 1], 0), 0, "Lost a path on eviction");
+  mobility[n - 1]->Dispose ();
+  NS_TEST_ASSERT_MSG_EQ (rsu->GetReferenceCount (), 1, "The cache still holds a mobility model without paths");
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +542,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationCacheTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
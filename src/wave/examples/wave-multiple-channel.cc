@@ -38,6 +38,13 @@
 #include "ns3/wave-net-device.h"
 #include "ns3/wave-mac-helper.h"
 #include "ns3/wave-helper.h"
+#include "ns3/service-channel-allocator.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/pointer.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
 
 using namespace ns3;
 
@@ -135,377 +142,6 @@ void
 	os << "packet=" << m_packetId << " sendTime=" << m_sendTime << " serviceChannel" << m_serviceChannel << " serviceSize" << m_serviceSize;
 }
 
-/**
-Each Service channel store the IP packet Information to each Queue
-Store the Serviced Channel Number, and IP Packet Size
-and Calculate Service Remain Time
-and Scheduling using SJF Scheduler
-*/
-
-typedef struct std::pair<Address, uint32_t> SentInfo;
-typedef struct std::pair<uint32_t, SentInfo> Items;
-
-typedef struct std::pair<uint32_t, Items> bItems;
-
-class ChannelQueues
-{
-public:
-	ChannelQueues ();
-	~ChannelQueues () {}
-	bool isEmpty(uint32_t ChannelNum);
-	//Packet have Packet size. So Calculate Service time and allocate Service channel
-	uint32_t Enqueue(Ptr<const Packet>, bool Scheduling, Address sender);
-	Items peek(uint32_t ChannelNum);
-	Items Dequeue(uint32_t ChannelNum);
-	void Update(uint32_t ChannelNum, uint32_t receiveSize);
-	void EnqueueRemains(uint32_t ChannelNum, uint32_t RemainSize, Address sender);
-	void PushBackups();
-	void DropService(uint32_t ChannelNum, Address sender);
-
-private:
-	void EnqueueSwitch(uint32_t Channel, Items item, uint32_t Count, uint32_t RemainTime, bool back);
-	uint32_t CalcServiceTime(uint32_t ServiceSize) { return (ServiceSize / 6001) + 1;}
-	uint32_t AllocServiceChannel(uint32_t RemainTime,  bool Scheduling);
-	bool CheckNodes(uint32_t Channel, Address node);
-	std::list<Items> Sch2List;
-	std::list<Items> Sch3List;
-	std::list<Items> Sch4List;
-	std::list<Items> Sch5List;
-
-	std::list<bItems> BackupList;
-
-	uint32_t Counts[4];
-	uint32_t Sums[4];
-	uint32_t current;
-};
-
-ChannelQueues::ChannelQueues(void)
-	: current(SCH2)
-{
-	for(int i = 0; i < 4; i++) {
-		Counts[i] = 0;
-		Sums[i] = 0;
-	}
-}
-
-void
-	ChannelQueues::EnqueueSwitch(uint32_t ChannelNum, Items item, uint32_t Count, uint32_t RemainTime, bool back)
-{
-	if(back)
-	{
-		switch(ChannelNum)
-		{
-		case SCH2: Sch2List.push_back(item); Counts[0]+=Count; Sums[0]+=RemainTime; break;
-		case SCH3: Sch3List.push_back(item); Counts[1]+=Count; Sums[1]+=RemainTime; break;
-		case SCH4: Sch4List.push_back(item); Counts[2]+=Count; Sums[2]+=RemainTime; break;
-		case SCH5: Sch5List.push_back(item); Counts[3]+=Count; Sums[3]+=RemainTime; break;
-		}
-	}
-	else
-	{
-		switch(ChannelNum)
-		{
-		case SCH2: Sch2List.push_front(item); Counts[0]+=Count; Sums[0]+=RemainTime; break;
-		case SCH3: Sch3List.push_front(item); Counts[1]+=Count; Sums[1]+=RemainTime; break;
-		case SCH4: Sch4List.push_front(item); Counts[2]+=Count; Sums[2]+=RemainTime; break;
-		case SCH5: Sch5List.push_front(item); Counts[3]+=Count; Sums[3]+=RemainTime; break;
-		}
-	}
-}
-
-bool
-	ChannelQueues::isEmpty(uint32_t ChannelNum)
-{
-	switch(ChannelNum) {
-	case SCH2: return Counts[0] == 0;
-	case SCH3: return Counts[1] == 0;
-	case SCH4: return Counts[2] == 0;
-	case SCH5: return Counts[3] == 0;
-	default: return false;
-	}
-}
-
-uint32_t
-	ChannelQueues::Enqueue(Ptr<const Packet> pkt, bool Scheduling, Address sender)
-{
-	StatsTag tag;
-	bool result;
-	result = pkt->FindFirstMatchingByteTag (tag);
-	if (!result)
-	{
-		NS_FATAL_ERROR ("the packet here shall have a stats tag");
-	}
-	uint32_t packetId = tag.GetPacketId ();
-	uint32_t ServiceSize = tag.GetServiceSize ();
-
-	for(uint32_t channel = SCH2; channel <= SCH5; channel+=2)
-	{
-		if(channel == CCH)
-			continue;
-		if(CheckNodes(channel, sender))
-			return -1;
-	}
-
-	uint32_t RemainTime = CalcServiceTime(ServiceSize);
-	uint32_t ChannelNum = AllocServiceChannel(RemainTime, Scheduling);
-
-	SentInfo info = std::make_pair(sender, 0);
-	Items item = std::make_pair(ServiceSize, info);
-
-	EnqueueSwitch(ChannelNum, item, 1, RemainTime, true);
-
-	return ChannelNum;
-}
-
-void 
-	ChannelQueues::EnqueueRemains(uint32_t ChannelNum, uint32_t RemainSize, Address sender)
-{
-	if(isEmpty(ChannelNum)) { // when RSU Send the packet and Finish the Job. but Node can't receive the Packet
-		// ADD Node's Info to RSU LIST
-		SentInfo info = std::make_pair(sender, 0);
-		Items item = std::make_pair(RemainSize, info);
-
-		uint32_t RemainTime = CalcServiceTime(RemainSize);
-		EnqueueSwitch(ChannelNum, item, 1, RemainTime, false);
-	}
-	else { // RSU Send Pakcet But Not Finish the Job. and Node know Job isnt finish
-		Items item = peek(ChannelNum);
-
-		if(sender != item.second.first)
-		{
-			// Check this Sender already exist in the Queue, if not return do nothing
-			if(CheckNodes(ChannelNum, sender))
-				return;
-			
-			if(item.second.second != 0) // RSU sent Packet but node doesnt confirm yet.. then Input End of Queue
-			{
-				SentInfo info = std::make_pair(sender, 0);
-				item = std::make_pair(RemainSize, info);
-				bItems bItem = std::make_pair(ChannelNum, item);
-
-				BackupList.push_back(bItem);
-
-				//uint32_t RemainTime = CalcServiceTime(RemainSize);
-				//EnqueueSwitch(ChannelNum, item, 1, RemainTime, true);
-			}
-			else // following Job doesnt start or start but partitailly finished
-			{ 
-				SentInfo info = std::make_pair(sender, 0);
-				item = std::make_pair(RemainSize, info);
-
-				uint32_t RemainTime = CalcServiceTime(RemainSize);
-				EnqueueSwitch(ChannelNum, item, 1, RemainTime, false);
-			}
-			return;
-		}
-		
-		item = Dequeue(ChannelNum);
-
-		if(item.first == RemainSize)	// Job is Exellent. Send packet and Receive all Pakcet
-		{
-			item.second.second = 0;
-			EnqueueSwitch(ChannelNum, item, 0, 0, false);
-			return;
-		}
-
-		// Job is Partitially Complete. Sent packet but receive one less
-		uint32_t RemainTime = CalcServiceTime(RemainSize - item.first);
-		item.first = RemainSize;
-
-		EnqueueSwitch(ChannelNum, item, 0, RemainTime, false);
-	}
-}
-
-void
-	ChannelQueues::PushBackups()
-{
-	while(!BackupList.empty())
-	{
-		bItems bitem = *(BackupList.begin());
-		uint32_t RemainTime = CalcServiceTime(bitem.second.first);
-		
-		EnqueueSwitch(bitem.first, bitem.second, 1, RemainTime, false);
-		BackupList.pop_front();
-	}
-}
-
-void
-	ChannelQueues::DropService(uint32_t Channel, Address node)
-{
-	if(!CheckNodes(Channel, node))	// When RSU know All the Schedule of node is Already Finished
-		return;
-
-	// When Services to node Remain in RSU Schedule
-	Items item = Dequeue(Channel);
-	uint32_t RemainTime = CalcServiceTime(item.first);
-	if(item.second.first == node)
-	{
-		switch(Channel)
-		{
-		case SCH2: Counts[0]--; Sums[0]-=RemainTime; break;
-		case SCH3: Counts[1]--; Sums[1]-=RemainTime; break;
-		case SCH4: Counts[2]--; Sums[2]-=RemainTime; break;
-		case SCH5: Counts[3]--; Sums[3]-=RemainTime; break;
-		}
-	}
-	else
-	{
-		Items drop = Dequeue(Channel);
-		RemainTime = CalcServiceTime(drop.first);
-		switch(Channel)
-		{
-		case SCH2: Counts[0]--; Sums[0]-=RemainTime; break;
-		case SCH3: Counts[1]--; Sums[1]-=RemainTime; break;
-		case SCH4: Counts[2]--; Sums[2]-=RemainTime; break;
-		case SCH5: Counts[3]--; Sums[3]-=RemainTime; break;
-		}
-
-		EnqueueSwitch(Channel, item, 0, 0, false);
-	}
-
-}
-
-bool
-	ChannelQueues::CheckNodes(uint32_t Channel, Address node)
-{
-	std::list<Items> SchList;
-	Items item;
-
-	switch(Channel)
-	{
-	case SCH2: SchList = Sch2List; break;
-	case SCH3: SchList = Sch3List; break;
-	case SCH4: SchList = Sch4List; break;
-	case SCH5: SchList = Sch5List; break;
-	}
-
-	while(!SchList.empty())
-	{
-		item = *(SchList.begin());
-		SchList.pop_front();
-		if(item.second.first == node)
-			return true;
-	}
-
-	return false;
-}
-
-Items
-	ChannelQueues::peek(uint32_t ChannelNum)
-{
-	Items item;
-
-	std::list<Items>::iterator iter;
-	switch(ChannelNum)
-	{
-	case SCH2: item = *(Sch2List.begin()); break;
-	case SCH3: item = *(Sch3List.begin()); break;
-	case SCH4: item = *(Sch4List.begin()); break;
-	case SCH5: item = *(Sch5List.begin()); break;
-	}
-	return item;
-}
-
-Items
-	ChannelQueues::Dequeue(uint32_t ChannelNum)
-{
-	Items item;
-
-	switch(ChannelNum)
-	{
-	case SCH2: item = *(Sch2List.begin()); Sch2List.pop_front(); break;
-	case SCH3: item = *(Sch3List.begin()); Sch3List.pop_front(); break;
-	case SCH4: item = *(Sch4List.begin()); Sch4List.pop_front(); break;
-	case SCH5: item = *(Sch5List.begin()); Sch5List.pop_front(); break;
-	}
-	return item;
-}
-
-uint32_t
-	ChannelQueues::AllocServiceChannel(uint32_t RemainTime, bool Scheduling)
-{
-	uint32_t selected;
-
-	if(Scheduling) // when using sjf scheduling
-	{
-		uint32_t min = Sums[0];
-		selected = SCH2;
-
-		if(min > Sums[1]) 
-		{
-			min = Sums[1];
-			selected = SCH3;
-		}
-		if(min > Sums[2]) 
-		{
-			min = Sums[2];
-			selected = SCH4;
-		}
-		if(min > Sums[3]) 
-		{
-			min = Sums[3];
-			selected = SCH5;
-		}
-	}
-	else
-	{
-		if(current > SCH5)
-			current = SCH2;
-		if(current == CCH)
-			current+=2;
-		selected = current;
-		current+=2;
-	}
-
-	return selected;
-}
-
-void
-	ChannelQueues::Update(uint32_t channelNum, uint32_t size)
-{
-	Items item;
-	bool boolean = false;
-
-	item = Dequeue(channelNum);
-	item.first-=size;
-	item.second.second+=size;
-
-	if(item.first == 0)
-		boolean = true;
-
-	switch(channelNum) {
-	case SCH2:
-		if(boolean)
-			Counts[0]--;
-		else
-			Sch2List.push_front(item);
-		Sums[0]--;
-		break;
-	case SCH3: 
-		if(boolean)
-			Counts[1]--;
-		else
-			Sch3List.push_front(item);
-		Sums[1]--; 
-		break;
-	case SCH4: 
-		if(boolean)
-			Counts[2]--;
-		else
-			Sch4List.push_front(item);
-		Sums[2]--; 
-		break;
-	case SCH5:
-		if(boolean)
-			Counts[3]--;
-		else
-			Sch5List.push_front(item); 
-		Sums[3]--; 
-		break;
-	}
-}
-
-
 /**
 * (1) some nodes are in constant speed mobility, every node sends
 * two types of packets.
@@ -546,7 +182,7 @@ const static uint16_t ACK_PROT_NUMBER = 0x88DD;
 // we suggest users use wave-transmission-range.cc to get this value
 #define Device_Transmission_Range 250
 
-class MultipleChannelExperiment
+class MultipleChannelExperiment : public ChannelCoordinationListener
 {
 public:
 	MultipleChannelExperiment (void);
@@ -556,11 +192,21 @@ public:
 	void Run (void);
 	void Stats (void);
 
+	// rebalance the service channels at the start of every CCH slot
+	virtual void NotifyCchSlotStart (Time duration);
+	virtual void NotifySchSlotStart (Time duration);
+	virtual void NotifyGuardSlotStart (Time duration, bool cchi);
+
 private:
 	void CreateWaveNodes (void);
 	void CheckRemainService (Ptr<WaveNetDevice> node);
 	void ChangeToServiceChannel (Ptr<WaveNetDevice> node);
 	void RSUSendPacket(Ptr<WaveNetDevice> node, uint32_t Num);
+	void RebalanceServiceChannels (void);
+	// the airtime of a chunk sent by a RSU and the bytes fitting in an airtime
+	Time CalculateChunkTime (Ptr<WaveNetDevice> sender, uint32_t size);
+	uint32_t CalculateChunkSize (Ptr<WaveNetDevice> sender, Time budget);
+	uint32_t CalculateSchCapacity (Ptr<WaveNetDevice> sender);
 
 	// we treat WSMP packets as safety message
 	//void SendWsmpPackets (Ptr<WaveNetDevice> sender, uint32_t channelNumber);
@@ -568,6 +214,8 @@ private:
 	void SendIpPackets (Address dest, uint32_t channelNum, uint32_t serviceSize);
 	// WSAs Packets
 	void SendWsaPackets(Ptr<WaveNetDevice> sender, uint32_t channelNumber);
+	// schedule the WSAs of all vehicles sent in the coming second
+	void ScheduleWsaPackets (void);
 	void SendAckPackets (Ptr<WaveNetDevice> sender, uint32_t channelNumber, Address receiver, uint32_t serviceChannel, uint32_t serviceSize);
 	bool Receive (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
 
@@ -584,7 +232,7 @@ private:
 	NetDeviceContainer devices;
 	NetDeviceContainer RSUdevices;
 
-	ChannelQueues ChannelQueue;
+	Ptr<ServiceChannelAllocator> allocator;
 
 	uint32_t nodesNumber;
 	uint32_t channelNow;
@@ -593,6 +241,7 @@ private:
 	uint32_t simulationTime;
 	uint32_t sizeSafety;
 	uint32_t sizeNonSafety;
+	uint32_t chunkSize;
 
 	Ptr<UniformRandomVariable> rngSafety;
 	Ptr<UniformRandomVariable> rngNonSafety;
@@ -629,6 +278,9 @@ private:
 	uint32_t ServiceFinish;
 
 	bool usingSJF;
+	bool usingSRPT;
+	bool usingStealing;
+	bool usingSharedCoordinator;
 
 	bool createTraceFile;
 	std::ofstream outfile;
@@ -642,6 +294,7 @@ MultipleChannelExperiment::MultipleChannelExperiment (void)
 	simulationTime (30),       // make it run 100s
 	sizeSafety (200),           // 100 bytes small size
 	sizeNonSafety (1500),       // 1500 bytes big size
+	chunkSize (6000),           // 6000 bytes per IP packet sent by RSU
 	safetyPacketID (0),
 	nonSafetyPacketID (0),
 	receiveSafety (0),
@@ -653,6 +306,9 @@ MultipleChannelExperiment::MultipleChannelExperiment (void)
 	ServiceCall (0),
 	ServiceFinish (0),
 	usingSJF(false),
+	usingSRPT(false),
+	usingStealing(false),
+	usingSharedCoordinator(false),
 	createTraceFile (true)
 {
 	for(int i = 0; i<4; i++)
@@ -670,9 +326,14 @@ bool
 	cmd.AddValue ("time", "Simulation time, s.", simulationTime);
 	cmd.AddValue ("sizeSafety", "Size of safety packet, bytes.", sizeSafety);
 	cmd.AddValue ("sizeNonSafety", "Size of non-safety packet, bytes.", sizeNonSafety);
+	cmd.AddValue ("chunkSize", "Maximum size of a service chunk sent by RSU, bytes.", chunkSize);
 	cmd.AddValue ("frequencySafety", "Frequency of sending safety packets, Hz.", frequencySafety);
 	cmd.AddValue ("frequencyNonSafety", "Frequency of sending non-safety packets, Hz.", frequencyNonSafety);
 	cmd.AddValue ("createTraceFile", "create trace file with 4 different configuration", createTraceFile);
+	cmd.AddValue ("sjf", "Allocate service channels with SJF scheduling instead of round robin.", usingSJF);
+	cmd.AddValue ("srpt", "Serve the jobs of a service channel by shortest remaining size instead of FIFO.", usingSRPT);
+	cmd.AddValue ("steal", "Move waiting jobs from backlogged service channels to idle ones.", usingStealing);
+	cmd.AddValue ("sharedCoordinator", "Share one channel coordinator among all the devices.", usingSharedCoordinator);
 
 	cmd.Parse (argc, argv);
 	return true;
@@ -737,6 +398,7 @@ void
 	wifiPhy.SetChannel (wifiChannel.Create ());
 	WaveMacHelper waveMac = WaveMacHelper::Default ();
 	WaveHelper waveHelper = WaveHelper::Default ();
+	Config::SetDefault ("ns3::WaveNetDevice::SharedChannelCoordinator", BooleanValue (usingSharedCoordinator));
 	devices = waveHelper.Install (wifiPhy, waveMac, nodes);
 	RSUdevices = waveHelper.Install (wifiPhy, waveMac, RSUs);
 
@@ -836,7 +498,7 @@ bool
 	if (mode == IPv4_PROT_NUMBER) // When Vehicles(receiver) receive IP Packet from RSU(sender)
 	{
 		receiver->UpdateSchedule(serviceSize);
-		//ChannelQueue.Update(serviceChannel, serviceSize);
+		//allocator->Update(serviceChannel, serviceSize);
 		if(!receiver->IsScheduled()) ServiceFinish++;
 
 		switch(serviceChannel)
@@ -852,10 +514,10 @@ bool
 	}
 	else if(mode == WSMP_PROT_NUMBER) // When RSU(receiver) receive WSA Message from Vehicle(sender)
 	{
-		// Allocate Channel and Send ACK Packet
-		int channelNum;
-
-		channelNum = ChannelQueue.Enqueue(pkt, usingSJF, sender);
+		// Allocate Channel and Send ACK Packet. If the ACK of the first
+		// request was lost, it is sent again with the channel already
+		// allocated to the vehicle.
+		uint32_t channelNum = allocator->Enqueue(sender, serviceSize);
 
 
 		// Send ACK Packet to Vehicle + NOT SCHEDULE
@@ -1059,12 +721,19 @@ void
 	uint32_t channel = node->GetScheduleChannel();
 	uint32_t size = node->GetScheduleSize();
 
+	// the ACK telling the vehicle its new channel was lost, so send it again
+	uint32_t queued = allocator->GetServiceChannel(node->GetAddress());
+	if(usingStealing && queued != 0 && queued != channel) {
+		SendAckPackets(DynamicCast<WaveNetDevice> (RSUdevices.Get (2)), CCH, node->GetAddress(), queued, size);
+		return;
+	}
+
 	if(node->DuplicationCounts()) {
-		ChannelQueue.EnqueueRemains(channel, size, node->GetAddress());
-		ChannelQueue.PushBackups();
+		allocator->EnqueueRemains(channel, size, node->GetAddress());
+		allocator->PushBackups();
 	}
 	else
-		ChannelQueue.DropService(channel, node->GetAddress());
+		allocator->DropService(channel, node->GetAddress());
 }
 
 void
@@ -1087,7 +756,7 @@ void
 	Simulator::Schedule (Seconds(0.001), &WaveNetDevice::RegisterTxProfile, node, profile);
 
 	// check Channel is ready for this node
-	//if(!ChannelQueue.isReady(node->GetSchedule()))
+	//if(!allocator->IsReady(node->GetSchedule()))
 	//	return;
 
 	Simulator::Schedule (Seconds (0.05),&WaveNetDevice::UnregisterTxProfile, node,node->GetScheduleChannel());
@@ -1103,32 +772,124 @@ void
 	if(channel == CCH)
 		return;
 
-	//while(!ChannelQueue.isEmpty(channel))
-	for(uint32_t i=0; i<2; i++)
+	// pack the chunks of queued jobs into the SCH slot after the guard interval
+	Ptr<ChannelCoordinator> coordinator = node->GetChannelCoordinator ();
+	Time budget = Min (coordinator->GetRemainTime (), coordinator->GetSchInterval () - coordinator->GetGuardInterval ());
+	Time t = coordinator->GetRemainTime () - budget;
+	while(!allocator->IsEmpty(channel))
 	{
-		if(ChannelQueue.isEmpty(channel))
-			break;
+		ServiceJob job = allocator->Peek(channel);
 
-		Items item = ChannelQueue.peek(channel);
+		uint32_t size = CalculateChunkSize (node, budget);
+		if(size == 0)
+			break;
+		if(size > job.remainSize)
+			size = job.remainSize;
+		budget -= CalculateChunkTime (node, size);
 
-		uint32_t size = item.first;
-		if(size > 6000)
-			size = 6000;
+		Simulator::Schedule (t, &MultipleChannelExperiment::SendIpPackets, this, job.vehicle, channel, size);
+		allocator->Update(channel, size);
+	}
+}
 
-		Address address = item.second.first;
+Time
+	MultipleChannelExperiment::CalculateChunkTime (Ptr<WaveNetDevice> sender, uint32_t size)
+{
+	Ptr<WifiRemoteStationManager> manager = sender->GetRemoteStationManager ();
+	WifiModeValue mode;
+	manager->GetAttribute ("DataMode", mode);
+	WifiTxVector txVector;
+	txVector.SetMode (mode.Get ());
+
+	Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (sender->GetMac ());
+	PointerValue ptr;
+	rmac->GetAttribute ("BE_EdcaTxopN", ptr);
+	Ptr<EdcaTxopN> edca = ptr.Get<EdcaTxopN> ();
+	Time sifs = rmac->GetSifs ();
+	int64_t slot = rmac->GetSlot ().GetNanoSeconds ();
+
+	// a chunk waits for AIFS and the largest initial backoff, then it is sent
+	// with LLC/SNAP header in fragments of QoS data frames (MAC header and FCS
+	// are 30 bytes) and every fragment is acknowledged by the vehicle after SIFS.
+	Time time = sifs + NanoSeconds (slot * (edca->GetAifsn () + edca->GetMinCw ()));
+	Time ack = WifiPhy::CalculateTxDuration (14, txVector, WIFI_PREAMBLE_LONG);
+	uint32_t fragmentSize = manager->GetFragmentationThreshold () - 30;
+	uint32_t msduSize = size + 8;
+	while (msduSize > 0)
+	{
+		uint32_t fragment = std::min (msduSize, fragmentSize);
+		msduSize -= fragment;
+		time += WifiPhy::CalculateTxDuration (fragment + 30, txVector, WIFI_PREAMBLE_LONG) + sifs + ack;
+		if (msduSize > 0)
+			time += sifs;
+	}
+	return time;
+}
 
-		Ptr<ChannelCoordinator> coordinator = node->GetChannelCoordinator ();
-		Time t = Seconds (rngSafety->GetValue (0, 0.04));
-		/*if (!coordinator->IsSchInterval (t))
-		{
-		t =  t + coordinator->NeedTimeToSchInterval (t)
-		+  MicroSeconds (rngOther->GetInteger (0, coordinator->GetSchInterval ().GetMicroSeconds () - 1));
-		}*/
+uint32_t
+	MultipleChannelExperiment::CalculateChunkSize (Ptr<WaveNetDevice> sender, Time budget)
+{
+	if (CalculateChunkTime (sender, 1) > budget)
+		return 0;
+	// the largest chunk not larger than chunkSize which can be sent in budget
+	uint32_t low = 1;
+	uint32_t high = chunkSize;
+	while (low < high)
+	{
+		uint32_t middle = (low + high + 1) / 2;
+		if (CalculateChunkTime (sender, middle) <= budget)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+	return low;
+}
 
-		Simulator::Schedule (t, &MultipleChannelExperiment::SendIpPackets, this, address, channel, size);
-		ChannelQueue.Update(channel, size);
+uint32_t
+	MultipleChannelExperiment::CalculateSchCapacity (Ptr<WaveNetDevice> sender)
+{
+	Ptr<ChannelCoordinator> coordinator = sender->GetChannelCoordinator ();
+	Time budget = coordinator->GetSchInterval () - coordinator->GetGuardInterval ();
+	uint32_t capacity = 0;
+	for (uint32_t size = CalculateChunkSize (sender, budget); size != 0; size = CalculateChunkSize (sender, budget))
+	{
+		capacity += size;
+		budget -= CalculateChunkTime (sender, size);
 	}
+	return capacity;
+}
+
+void
+	MultipleChannelExperiment::NotifyCchSlotStart (Time duration)
+{
+	RebalanceServiceChannels ();
+}
+
+void
+	MultipleChannelExperiment::NotifySchSlotStart (Time duration)
+{
+}
+
+void
+	MultipleChannelExperiment::NotifyGuardSlotStart (Time duration, bool cchi)
+{
+}
+
+void
+	MultipleChannelExperiment::RebalanceServiceChannels (void)
+{
+	NS_LOG_FUNCTION (this);
 
+	// the vehicles have reported their remaining services at the start of this
+	// CCH interval, so they will be told their new channels by ACK in time for
+	// the next SCH interval.
+	Ptr<WaveNetDevice> sender = DynamicCast<WaveNetDevice> (RSUdevices.Get (2));
+	std::list<std::pair<uint32_t, ServiceJob> > migrations = allocator->Rebalance ();
+	std::list<std::pair<uint32_t, ServiceJob> >::iterator i;
+	for (i = migrations.begin (); i != migrations.end (); ++i)
+	{
+		SendAckPackets (sender, CCH, i->second.vehicle, i->first, i->second.remainSize);
+	}
 }
 
 void
@@ -1178,6 +939,19 @@ void
 	broadcastPackets.clear();
 
 	Simulator::ScheduleDestroy (&MultipleChannelExperiment::StatQueuedPackets, this);
+
+	// one service channel for each RSU except the RSU looking CCH
+	allocator = CreateObject<ServiceChannelAllocator> ();
+	allocator->SetAttribute ("Policy", EnumValue (usingSJF ? ServiceChannelAllocator::SJF_ALLOCATION
+		: ServiceChannelAllocator::ROUND_ROBIN_ALLOCATION));
+	allocator->SetAttribute ("ServiceOrder", EnumValue (usingSRPT ? ServiceChannelAllocator::SRPT_ORDER
+		: ServiceChannelAllocator::FIFO_ORDER));
+	for (uint32_t channel = SCH2; channel <= SCH5; channel += 2)
+	{
+		if (channel == CCH)
+			continue;
+		allocator->AddServiceChannel (channel);
+	}
 }
 
 void
@@ -1252,66 +1026,65 @@ void
 	MultipleChannelExperiment::ConfigurationA (void)
 {
 	NS_LOG_FUNCTION (this);
-	for (uint32_t time = 0; time != simulationTime; ++time)	// simulation time : 10, each time is 1 Second
+	// the service time of a job is counted in SCH intervals served at the data rate of RSU
+	uint32_t capacity = CalculateSchCapacity (DynamicCast<WaveNetDevice> (RSUdevices.Get (0)));
+	NS_LOG_DEBUG ("a service channel delivers " << capacity << " bytes per SCH interval");
+	allocator->SetAttribute ("ServiceUnit", UintegerValue (capacity));
+	if (usingStealing)
 	{
+		// the RSU looking CCH sends ACKs, so it also tells vehicles their new channels
+		Ptr<WaveNetDevice> rsu = DynamicCast<WaveNetDevice> (RSUdevices.Get (2));
+		rsu->GetChannelCoordinator ()->RegisterListener (this);
+	}
+	// every send slot repeats each second, only the next occurrence of a slot is scheduled,
+	// so the pending events are bounded by the number of nodes instead of the simulation time
+	for (uint32_t sends = 0; sends != frequencySafety; ++sends)	// fequency : 10, each sends is 100ms
+	{
+		NetDeviceContainer::Iterator i;
+		uint32_t channel;
+		for (i = devices.Begin (); i != devices.End (); ++i)
+		{
+			Ptr<WaveNetDevice> node = DynamicCast<WaveNetDevice> (*i);
 
-		for (uint32_t sends = 0; sends != frequencySafety; ++sends)	// fequency : 10, each sends is 100ms
+			Simulator::SchedulePeriodic (Seconds (0.1 * sends), Seconds (1), simulationTime, &MultipleChannelExperiment::CheckRemainService, this, node);
+			Simulator::SchedulePeriodic (Seconds (0.1 * sends + 0.05), Seconds (1), simulationTime, &MultipleChannelExperiment::ChangeToServiceChannel, this, node);
+		}
+
+		for (i = RSUdevices.Begin(), channel = SCH2; i != RSUdevices.End(); ++i, channel+=2)
 		{
-			NetDeviceContainer::Iterator i;
-			uint32_t channel;
-			for (i = devices.Begin (); i != devices.End (); ++i)
-			{
-				Ptr<WaveNetDevice> node = DynamicCast<WaveNetDevice> (*i);
-				Ptr<ChannelCoordinator> coordinator = node->GetChannelCoordinator ();
-
-				Simulator::Schedule(Seconds(time + (0.1 * sends)), &MultipleChannelExperiment::CheckRemainService, this, node);
-
-				Time t = Seconds (rngSafety->GetValue (time, time + 1));
-				//Time t = Seconds (rngSafety->GetValue (0, 0.05));
-				// if the send time is not at CCHI, we will calculate a new time
-				if (!coordinator->IsCchInterval (t))
-				{
-					t = t + coordinator->NeedTimeToCchInterval (t)
-						+  MicroSeconds (rngOther->GetInteger (0, coordinator->GetCchInterval ().GetMicroSeconds () - 1));
-				}
-
-				Simulator::Schedule (t, &MultipleChannelExperiment::SendWsaPackets, this, node, CCH);
-				//Simulator::Schedule (Seconds(time + (0.1 * sends)) + t, &MultipleChannelExperiment::SendWsaPackets, this, node, CCH);
-				Simulator::Schedule (Seconds(time + (0.1 * sends) + 0.05), &MultipleChannelExperiment::ChangeToServiceChannel, this, node);
-			}
+			Ptr<WaveNetDevice> node = DynamicCast<WaveNetDevice> (*i);
 
-			for (i = RSUdevices.Begin(), channel = SCH2; i != RSUdevices.End(); ++i, channel+=2)
-			{
-				Ptr<WaveNetDevice> node = DynamicCast<WaveNetDevice> (*i);
+			if(channel == CCH)
+				continue;	// skip Basic RSU looking CCH
 
-				if(channel == CCH)
-					continue;	// skip Basic RSU looking CCH
+			Simulator::SchedulePeriodic (Seconds (0.1 * sends + 0.05), Seconds (1), simulationTime, &MultipleChannelExperiment::RSUSendPacket, this, node, channel);
+		}
+	}
+	Simulator::SchedulePeriodic (Seconds (0), Seconds (1), simulationTime, &MultipleChannelExperiment::ScheduleWsaPackets, this);
+}
 
-				Simulator::Schedule (Seconds(time + (0.1 * sends) + 0.05), &MultipleChannelExperiment::RSUSendPacket, this, node, channel);
-			}
-			/*
-			{ // when it is service interval
-			uint32_t channelNumber = node->GetSchedule();
-			SchInfo schInfo = SchInfo (channelNumber, false, 0x0);
-			Simulator::Schedule (Seconds (Seconds(time)),&WaveNetDevice::StartSch,node,schInfo);
-			TxProfile profile = TxProfile (channelNumber);
-			Simulator::Schedule (Seconds (Seconds(time)), &WaveNetDevice::RegisterTxProfile, node, profile);
-
-			for (uint32_t sends = 0; sends != frequencyNonSafety; ++sends)
-			{
-			Time t = Seconds (rngNonSafety->GetValue (time, time + 1));
+void
+	MultipleChannelExperiment::ScheduleWsaPackets (void)
+{
+	NS_LOG_FUNCTION (this);
+	double time = Now ().GetSeconds ();
+	for (uint32_t sends = 0; sends != frequencySafety; ++sends)
+	{
+		NetDeviceContainer::Iterator i;
+		for (i = devices.Begin (); i != devices.End (); ++i)
+		{
+			Ptr<WaveNetDevice> node = DynamicCast<WaveNetDevice> (*i);
+			Ptr<ChannelCoordinator> coordinator = node->GetChannelCoordinator ();
+
+			Time t = Seconds (rngSafety->GetValue (time, time + 1));
 			// if the send time is not at CCHI, we will calculate a new time
-			if (!coordinator->IsSchInterval (t))
+			if (!coordinator->IsCchInterval (t))
 			{
-			t =  t
-			+ coordinator->NeedTimeToSchInterval (t)
-			+  MicroSeconds (rngOther->GetInteger (0, coordinator->GetSchInterval ().GetMicroSeconds () - 1));
-			}
-			Simulator::Schedule (t, &MultipleChannelExperiment::SendIpPackets, this, node, channelNumber);
+				t = t + coordinator->NeedTimeToCchInterval (t)
+					+  MicroSeconds (rngOther->GetInteger (0, coordinator->GetCchInterval ().GetMicroSeconds () - 1));
 			}
-			Simulator::Schedule (Seconds (Seconds(time + 1)),&WaveNetDevice::UnregisterTxProfile, node,node->GetSchedule());
-			Simulator::Schedule (Seconds (Seconds(time + 1)),&WaveNetDevice::StopSch, node, channelNumber);
-			}*/
+
+			Simulator::Schedule (t - Now (), &MultipleChannelExperiment::SendWsaPackets, this, node, CCH);
 		}
 	}
 }
@@ -160,6 +160,15 @@ private:
   void InstallApplicationC (void);
   void InstallApplicationD (void);
 
+  // the interval which the send time of a packet is moved into
+  enum SendInterval
+  {
+    ANY_INTERVAL,
+    CCH_INTERVAL,
+    SCH_INTERVAL,
+  };
+  // schedule the packets sent by a sender in the coming second
+  void ScheduleSends (Ptr<WaveNetDevice> sender, enum SendInterval interval);
   void Send (Ptr<WaveNetDevice> sender, uint32_t channelNumber);
   bool Receive (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
 
@@ -589,6 +598,30 @@ MultipleChannelsExperiment::StatQueuedPackets ()
   }
 }
 
+void
+MultipleChannelsExperiment::ScheduleSends (Ptr<WaveNetDevice> sender, enum SendInterval interval)
+{
+  NS_LOG_FUNCTION (this << sender << interval);
+  Ptr<ChannelCoordinator> coordinator = sender->GetChannelCoordinator ();
+  double time = Now ().GetSeconds ();
+  for (uint32_t sends = 0; sends != freq; ++sends)
+    {
+      Time system_throughput = Seconds (rng->GetValue (time, time + 1));
+      // if the send time is not in CCHI, we will add a duration, then the send time will be in CCHI.
+      // note that: this simple mechanism can be used when CCHI is equal to SCHI. If SCHI is 60ms and CCHI is 40ms,
+      // this mechanism could be broken. So we need a better approach to enable packets sent in CCHI.
+      if (interval == CCH_INTERVAL && !coordinator->IsCchInterval (system_throughput))
+        {
+          system_throughput += coordinator->GetCchInterval ();
+        }
+      if (interval == SCH_INTERVAL && !coordinator->IsSchInterval (system_throughput))
+        {
+          system_throughput += coordinator->GetSchInterval ();
+        }
+      Simulator::Schedule (system_throughput - Now (), &MultipleChannelsExperiment::Send, this, sender, CCH);
+    }
+}
+
 void
 MultipleChannelsExperiment::InstallApplicationA (void)
 {
@@ -600,13 +633,9 @@ MultipleChannelsExperiment::InstallApplicationA (void)
 
       // to get continuous access for CCH, we do not need to call assignment method
 
-      for (uint32_t time = 0; time != simulationTime; ++time)
-        {
-          for (uint32_t sends = 0; sends != freq; ++sends)
-            {
-              Simulator::Schedule (Seconds (rng->GetValue (time, time + 1)), &MultipleChannelsExperiment::Send, this, sender, CCH);
-            }
-        }
+      // the packets of a second are scheduled at the start of the second
+      Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), simulationTime,
+                                   &MultipleChannelsExperiment::ScheduleSends, this, sender, ANY_INTERVAL);
 
   // or we can call assignment method to get continuous access for other SCH,
   // then send packet in the SCH
@@ -629,13 +658,8 @@ MultipleChannelsExperiment::InstallApplicationB (void)
       SchInfo schInfo = SchInfo (SCH1, false, 0x0);
       Simulator::Schedule (Seconds (0.0), &WaveNetDevice::StartSch, sender, schInfo);
 
-      for (uint32_t time = 0; time != simulationTime; ++time)
-        {
-          for (uint32_t sends = 0; sends != freq; ++sends)
-            {
-              Simulator::Schedule (Seconds (rng->GetValue (time, time + 1)), &MultipleChannelsExperiment::Send, this, sender, CCH);
-            }
-        }
+      Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), simulationTime,
+                                   &MultipleChannelsExperiment::ScheduleSends, this, sender, ANY_INTERVAL);
     }
 }
 
@@ -650,22 +674,8 @@ MultipleChannelsExperiment::InstallApplicationC (void)
       SchInfo schInfo = SchInfo (SCH1, false, 0x0);
       Simulator::Schedule (Seconds (0.0),&WaveNetDevice::StartSch,sender,schInfo);
 
-      Ptr<ChannelCoordinator> coordinator = sender->GetChannelCoordinator ();
-      for (uint32_t time = 0; time != simulationTime; ++time)
-        {
-          for (uint32_t sends = 0; sends != freq; ++sends)
-            {
-              Time system_throughput = Seconds (rng->GetValue (time, time + 1));
-              // if the send time is not in CCHI, we will add a duration, then the send time will be in CCHI.
-              // note that: this simple mechanism can be used when CCHI is equal to SCHI. If SCHI is 60ms and CCHI is 40ms,
-              // this mechanism could be broken. So we need a better approach to enable packets sent in CCHI.
-              if (!coordinator->IsCchInterval (system_throughput))
-                {
-                  system_throughput += coordinator->GetCchInterval ();
-                }
-              Simulator::Schedule (system_throughput, &MultipleChannelsExperiment::Send, this, sender, CCH);
-            }
-        }
+      Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), simulationTime,
+                                   &MultipleChannelsExperiment::ScheduleSends, this, sender, CCH_INTERVAL);
     }
 }
 
@@ -680,19 +690,8 @@ MultipleChannelsExperiment::InstallApplicationD (void)
       SchInfo schInfo = SchInfo (SCH1, false, 0x0);
       Simulator::Schedule (Seconds (0.0), &WaveNetDevice::StartSch, sender, schInfo);
 
-      Ptr<ChannelCoordinator> coordinator = sender->GetChannelCoordinator ();
-      for (uint32_t time = 0; time != simulationTime; ++time)
-        {
-          for (uint32_t sends = 0; sends != freq; ++sends)
-            {
-              Time system_throughput = Seconds (rng->GetValue (time, time + 1));
-              if (!coordinator->IsSchInterval (system_throughput))
-                {
-                  system_throughput += coordinator->GetSchInterval ();
-                }
-              Simulator::Schedule (system_throughput, &MultipleChannelsExperiment::Send, this, sender, CCH);
-            }
-        }
+      Simulator::SchedulePeriodic (Seconds (0.0), Seconds (1.0), simulationTime,
+                                   &MultipleChannelsExperiment::ScheduleSends, this, sender, SCH_INTERVAL);
     }
 }
 
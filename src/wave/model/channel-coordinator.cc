@@ -20,6 +20,7 @@
 #include "ns3/log.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include <map>
 
 NS_LOG_COMPONENT_DEFINE ("ChannelCoordinator");
 
@@ -60,7 +61,8 @@ ChannelCoordinator::GetTypeId (void)
 }
 
 ChannelCoordinator::ChannelCoordinator ()
-  : m_guardCount (0)
+  : m_guardCount (0),
+    m_shared (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -70,6 +72,47 @@ ChannelCoordinator::~ChannelCoordinator ()
   NS_LOG_FUNCTION (this);
 }
 
+// the shared coordinators, by system id, until Simulator::Destroy
+typedef std::map<uint32_t, Ptr<ChannelCoordinator> > SharedCoordinators;
+static SharedCoordinators *g_sharedCoordinators = 0;
+
+Ptr<ChannelCoordinator>
+ChannelCoordinator::GetShared (uint32_t systemId)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (g_sharedCoordinators == 0)
+    {
+      g_sharedCoordinators = new SharedCoordinators ();
+      Simulator::ScheduleDestroy (&ChannelCoordinator::DisposeShared);
+    }
+  Ptr<ChannelCoordinator> &coordinator = (*g_sharedCoordinators)[systemId];
+  if (coordinator == 0)
+    {
+      coordinator = CreateObject<ChannelCoordinator> ();
+      coordinator->m_shared = true;
+    }
+  return coordinator;
+}
+
+void
+ChannelCoordinator::DisposeShared (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (SharedCoordinators::iterator i = g_sharedCoordinators->begin (); i != g_sharedCoordinators->end (); ++i)
+    {
+      i->second->Dispose ();
+    }
+  delete g_sharedCoordinators;
+  g_sharedCoordinators = 0;
+}
+
+bool
+ChannelCoordinator::IsShared (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_shared;
+}
+
 void
 ChannelCoordinator::DoInitialize (void)
 {
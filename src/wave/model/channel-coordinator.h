@@ -71,6 +71,15 @@ public:
  *  of YansWifiPhy is 250 microseconds, here GI will be taken as virtual channel
  *  switch time of wave mac extension layer, so the wave device will be in busy state
  *  and could neither send nor receive.
+ *
+ *  Since the channel intervals are aligned on UTC, the devices which do
+ *  not model a clock offset may share the coordinator of GetShared,
+ *  which schedules one event per slot for all of them rather than one
+ *  per device, see the WaveNetDevice SharedChannelCoordinator attribute.
+ *  The listeners of a shared coordinator are all notified in the context
+ *  of the node which initialized it first, and so are the events which
+ *  they schedule: the node id of the logs and of Simulator::GetContext
+ *  in these events is the one of that node, not of the listening device.
  */
 class ChannelCoordinator : public Object
 {
@@ -79,6 +88,23 @@ public:
   ChannelCoordinator ();
   virtual ~ChannelCoordinator ();
 
+  /**
+   * \param systemId the system id of the nodes of the devices
+   * \returns the coordinator shared by the devices of the nodes of systemId
+   *
+   * The coordinator is created on the first call for systemId, with the
+   * default values of the attributes, and it is disposed of by
+   * Simulator::Destroy. Its slot events run in the context of the node
+   * of the first device which initializes it, so that the events of each
+   * partition of a parallel simulation stay in the partition. This method
+   * shall be called before the simulation runs.
+   */
+  static Ptr<ChannelCoordinator> GetShared (uint32_t systemId = 0);
+  /**
+   * \returns whether this coordinator is returned by GetShared
+   */
+  bool IsShared (void) const;
+
   static Time GetDefaultCchInterval (void);
   static Time GetDefaultSchInterval (void);
   static Time GetDefaultSyncInterval (void);
@@ -168,6 +194,8 @@ private:
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
 
+  static void DisposeShared (void);
+
   void StartChannelCoordination (void);
   void StopChannelCoordination (void);
 
@@ -197,6 +225,7 @@ private:
 
   uint32_t m_guardCount;
   EventId m_coordination;
+  bool m_shared;
 };
 
 }
@@ -98,7 +98,12 @@ ChannelScheduler::DoDispose (void)
   NS_LOG_FUNCTION (this);
 
   // we just need set to 0,
-  // WaveNetDevice will call DoDispose of m_manager and m_coordinator
+  // WaveNetDevice will call DoDispose of m_manager and m_coordinator,
+  // unless the coordinator is shared with other devices
+  if (m_coordinationListener != 0)
+    {
+      m_coordinator->UnregisterListener (m_coordinationListener);
+    }
   m_manager = 0;
   m_coordinator = 0;
   m_device = 0;
@@ -124,9 +129,26 @@ void
 ChannelScheduler::SetChannelCoodinator (Ptr<ChannelCoordinator> coordinator)
 {
   NS_LOG_FUNCTION (this << coordinator);
+  if (m_coordinationListener != 0)
+    {
+      m_coordinator->UnregisterListener (m_coordinationListener);
+      delete m_coordinationListener;
+    }
   m_coordinator = coordinator;
   m_coordinationListener = new CoordinationListener (this);
   m_coordinator->RegisterListener (m_coordinationListener);
+  if (m_mac != 0)
+    {
+      // replaced after DoInitialize, so nothing else starts the coordination
+      m_coordinator->Initialize ();
+    }
+}
+
+Ptr<ChannelCoordinator>
+ChannelScheduler::GetChannelCoordinator (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_coordinator;
 }
 
 bool
@@ -327,18 +349,37 @@ ChannelScheduler::StartSch (const SchInfo & schInfo)
 
   uint32_t cn = schInfo.channelNumber;
   uint8_t extends = schInfo.extendedAccess;
+  bool result;
   // now only support channel continuous access and extended access
   if (extends == EXTENDS_CONTINUOUS)
     {
-      return AssignContinuousAccess (cn, schInfo.immediateAccess);
+      result = AssignContinuousAccess (cn, schInfo.immediateAccess);
     }
   else if (extends == EXTENDS_ALTERNATING)
     {
-      return AssignAlternatingAccess (cn, schInfo.immediateAccess);
+      result = AssignAlternatingAccess (cn, schInfo.immediateAccess);
     }
   else
     {
-      return AssignExtendedAccess (cn, schInfo.extendedAccess, schInfo.immediateAccess);
+      result = AssignExtendedAccess (cn, schInfo.extendedAccess, schInfo.immediateAccess);
+    }
+  if (result)
+    {
+      SetChannelEdca (cn, schInfo.edcaParameterSet);
+    }
+  return result;
+}
+
+void
+ChannelScheduler::SetChannelEdca (uint32_t channelNumber, const EdcaParameterSet &edca)
+{
+  NS_LOG_FUNCTION (this << channelNumber);
+  // the queues switch to the parameters of the channel with the channel,
+  // so they are set once here rather than on each channel switch.
+  m_mac->ResetChannelEdca (channelNumber);
+  for (EdcaParameterSetI i = edca.begin (); i != edca.end (); ++i)
+    {
+      m_mac->ConfigureChannelEdca (channelNumber, i->second.cwmin, i->second.cwmax, i->second.aifsn, i->first);
     }
 }
 
@@ -378,6 +419,7 @@ ChannelScheduler::Release (uint32_t channelNumber)
       break;
     }
 
+  m_mac->ResetChannelEdca (m_channelNumber);
   AssignDefaultCchAccess();
 }
 
@@ -45,6 +45,8 @@ typedef std::map<AcIndex,EdcaParameter>::const_iterator EdcaParameterSetI;
  * access (during both SCH interval and CCH interval) to the SCH for ExtendedAccess
  * control channel intervals. A value of 255 indicates indefinite access.
  * \param edcaParameterSet If present, as specified in IEEE Std 802.11.
+ * The contention windows and the AIFSN of each access category present
+ * are used on the channel while its access is assigned.
  *
  * note: operationalRateSet is not supported yet.
  */
@@ -103,7 +105,17 @@ public:
   virtual ~ChannelScheduler (void);
   void SetWaveDevice (Ptr<NetDevice> device);
   void SetChannelManager (Ptr<ChannelManager> manager);
+  /**
+   * \param coordinator the coordinator of the channel intervals
+   *
+   * If the scheduler is already initialized, the coordinator is
+   * initialized too, so that it notifies the scheduler of its slots.
+   */
   void SetChannelCoodinator (Ptr<ChannelCoordinator> coordinator);
+  /**
+   * \returns the coordinator which the scheduler listens to
+   */
+  Ptr<ChannelCoordinator> GetChannelCoordinator (void) const;
 
   /**
    * whether channel access is assigned except default CCH access
@@ -174,6 +186,15 @@ private:
    * This method will assign default CCH access.
    */
   void AssignDefaultCchAccess (void);
+  /**
+   * \param channelNumber the channel whose access was assigned
+   * \param edca the EDCA parameters of the access categories on the channel
+   *
+   * The EDCA queues use these parameters whenever they switch to the
+   * channel, and the parameters of ConfigureEdca for the access
+   * categories which are not in edca, until the channel is released.
+   */
+  void SetChannelEdca (uint32_t channelNumber, const EdcaParameterSet &edca);
 
 
 
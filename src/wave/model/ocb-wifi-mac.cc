@@ -344,6 +344,33 @@ OcbWifiMac::ConfigureEdca (uint32_t cwmin, uint32_t cwmax, uint32_t aifsn, enum
 	}
 }
 
+void
+OcbWifiMac::ConfigureChannelEdca (uint32_t channelNumber, uint32_t cwmin, uint32_t cwmax, uint32_t aifsn, enum AcIndex ac)
+{
+  NS_LOG_FUNCTION (this << channelNumber << cwmin << cwmax << aifsn << ac);
+  NS_ASSERT (m_macExtensionSupport);
+  EdcaQueues::iterator i = m_edca.find (ac);
+  if (i == m_edca.end ())
+    {
+      NS_LOG_DEBUG ("no EDCA queue for the access category " << ac);
+      return;
+    }
+  Ptr<WaveEdcaTxopN> edca = DynamicCast<WaveEdcaTxopN> (i->second);
+  edca->SetChannelEdca (channelNumber, cwmin, cwmax, aifsn);
+}
+
+void
+OcbWifiMac::ResetChannelEdca (uint32_t channelNumber)
+{
+  NS_LOG_FUNCTION (this << channelNumber);
+  NS_ASSERT (m_macExtensionSupport);
+  for (EdcaQueues::iterator i = m_edca.begin (); i != m_edca.end (); ++i)
+    {
+      Ptr<WaveEdcaTxopN> edca = DynamicCast<WaveEdcaTxopN> (i->second);
+      edca->ResetChannelEdca (channelNumber);
+    }
+}
+
 void
 OcbWifiMac::FinishConfigureStandard (enum WifiPhyStandard standard)
 {
@@ -132,6 +132,24 @@ public:
    * configure EDCA queue parameters
    */
   void ConfigureEdca (uint32_t cwmin, uint32_t cwmax, uint32_t aifsn, enum AcIndex ac);
+  /**
+   * \param channelNumber the WAVE channel
+   * \param cwmin the min contention window
+   * \param cwmax the max contention window
+   * \param aifsn the arbitration inter-frame space
+   * \param ac    the access category index
+   *
+   * configure the EDCA parameters of an EDCA queue on a channel, used
+   * as they are rather than derived from cwmin as by ConfigureEdca.
+   * This requires the MAC extension of WAVE.
+   */
+  void ConfigureChannelEdca (uint32_t channelNumber, uint32_t cwmin, uint32_t cwmax, uint32_t aifsn, enum AcIndex ac);
+  /**
+   * \param channelNumber the WAVE channel
+   *
+   * use the EDCA parameters set by ConfigureEdca on the channel again.
+   */
+  void ResetChannelEdca (uint32_t channelNumber);
 
 protected:
   virtual void FinishConfigureStandard (enum WifiPhyStandard standard);
@@ -0,0 +1,523 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "service-channel-allocator.h"
+
+NS_LOG_COMPONENT_DEFINE ("ServiceChannelAllocator");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (ServiceChannelAllocator);
+
+TypeId
+ServiceChannelAllocator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ServiceChannelAllocator")
+    .SetParent<Object> ()
+    .AddConstructor<ServiceChannelAllocator> ()
+    .AddAttribute ("Policy", "The policy used to allocate a service channel to a new service request.",
+                   EnumValue (SJF_ALLOCATION),
+                   MakeEnumAccessor (&ServiceChannelAllocator::SetPolicy,
+                                     &ServiceChannelAllocator::GetPolicy),
+                   MakeEnumChecker (SJF_ALLOCATION, "Sjf",
+                                    ROUND_ROBIN_ALLOCATION, "RoundRobin",
+                                    LEAST_LOADED_ALLOCATION, "LeastLoaded"))
+    .AddAttribute ("ServiceOrder", "The order in which the jobs queued on a service channel are served.",
+                   EnumValue (FIFO_ORDER),
+                   MakeEnumAccessor (&ServiceChannelAllocator::SetServiceOrder,
+                                     &ServiceChannelAllocator::GetServiceOrder),
+                   MakeEnumChecker (FIFO_ORDER, "Fifo",
+                                    SRPT_ORDER, "Srpt"))
+    .AddAttribute ("ServiceUnit", "The bytes a service channel delivers in one SCH interval, "
+                   "used to convert the size of a service into the number of SCH intervals needed to deliver it.",
+                   UintegerValue (6001),
+                   MakeUintegerAccessor (&ServiceChannelAllocator::m_serviceUnit),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+ServiceChannelAllocator::ServiceChannelAllocator (void)
+  : m_policy (SJF_ALLOCATION),
+    m_order (FIFO_ORDER),
+    m_next (0),
+    m_serviceUnit (6001)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ServiceChannelAllocator::~ServiceChannelAllocator (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ServiceChannelAllocator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channels.clear ();
+  m_backups.clear ();
+  m_vehicles.clear ();
+  m_timeHeap.clear ();
+  m_jobHeap.clear ();
+  Object::DoDispose ();
+}
+
+void
+ServiceChannelAllocator::AddServiceChannel (uint32_t channelNumber)
+{
+  NS_LOG_FUNCTION (this << channelNumber);
+  if (!ChannelManager::IsSch (channelNumber))
+    {
+      NS_FATAL_ERROR ("channel " << channelNumber << " is not a valid service channel");
+    }
+  if (GetIndex (channelNumber) != m_channels.size ())
+    {
+      NS_LOG_DEBUG ("channel " << channelNumber << " is already used");
+      return;
+    }
+  ServiceChannel channel;
+  channel.channelNumber = channelNumber;
+  channel.jobCount = 0;
+  channel.remainTime = 0;
+  uint32_t index = m_channels.size ();
+  m_channels.push_back (channel);
+  m_timeHeap.insert (std::make_pair (0, index));
+  m_jobHeap.insert (std::make_pair (0, index));
+}
+
+void
+ServiceChannelAllocator::AddAllServiceChannels (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t channel = SCH1; channel <= SCH6; channel += 2)
+    {
+      if (ChannelManager::IsSch (channel))
+        {
+          AddServiceChannel (channel);
+        }
+    }
+}
+
+std::vector<uint32_t>
+ServiceChannelAllocator::GetServiceChannels (void) const
+{
+  std::vector<uint32_t> channels;
+  for (std::vector<ServiceChannel>::const_iterator i = m_channels.begin (); i != m_channels.end (); ++i)
+    {
+      channels.push_back (i->channelNumber);
+    }
+  return channels;
+}
+
+void
+ServiceChannelAllocator::SetPolicy (enum AllocationPolicy policy)
+{
+  NS_LOG_FUNCTION (this << policy);
+  m_policy = policy;
+}
+
+enum ServiceChannelAllocator::AllocationPolicy
+ServiceChannelAllocator::GetPolicy (void) const
+{
+  return m_policy;
+}
+
+void
+ServiceChannelAllocator::SetServiceOrder (enum ServiceOrder order)
+{
+  NS_LOG_FUNCTION (this << order);
+  NS_ASSERT_MSG (m_vehicles.empty (), "the service order shall be set before any job is queued");
+  m_order = order;
+}
+
+enum ServiceChannelAllocator::ServiceOrder
+ServiceChannelAllocator::GetServiceOrder (void) const
+{
+  return m_order;
+}
+
+uint32_t
+ServiceChannelAllocator::GetIndex (uint32_t channelNumber) const
+{
+  for (uint32_t index = 0; index != m_channels.size (); ++index)
+    {
+      if (m_channels[index].channelNumber == channelNumber)
+        {
+          return index;
+        }
+    }
+  return m_channels.size ();
+}
+
+uint32_t
+ServiceChannelAllocator::CalculateServiceTime (uint32_t serviceSize) const
+{
+  return (serviceSize / m_serviceUnit) + 1;
+}
+
+void
+ServiceChannelAllocator::UpdateLoad (uint32_t index, uint32_t oldJobs, uint32_t oldTime)
+{
+  const ServiceChannel &channel = m_channels[index];
+  if (oldTime != channel.remainTime)
+    {
+      m_timeHeap.erase (std::make_pair (oldTime, index));
+      m_timeHeap.insert (std::make_pair (channel.remainTime, index));
+    }
+  if (oldJobs != channel.jobCount)
+    {
+      m_jobHeap.erase (std::make_pair (oldJobs, index));
+      m_jobHeap.insert (std::make_pair (channel.jobCount, index));
+    }
+}
+
+void
+ServiceChannelAllocator::PushJob (uint32_t index, const ServiceJob &job, bool back)
+{
+  ServiceChannel &channel = m_channels[index];
+  uint32_t oldJobs = channel.jobCount;
+  JobsI position;
+  if (m_order == SRPT_ORDER)
+    {
+      // behind the jobs which are not longer, so equal jobs are served in turn
+      position = channel.jobs.begin ();
+      while (position != channel.jobs.end () && position->remainSize <= job.remainSize)
+        {
+          ++position;
+        }
+    }
+  else
+    {
+      position = back ? channel.jobs.end () : channel.jobs.begin ();
+    }
+  position = channel.jobs.insert (position, job);
+  channel.jobCount++;
+  m_vehicles[job.vehicle] = std::make_pair (index, position);
+  UpdateLoad (index, oldJobs, channel.remainTime);
+}
+
+void
+ServiceChannelAllocator::SortJob (VehicleIndexI i)
+{
+  if (m_order != SRPT_ORDER)
+    {
+      return;
+    }
+  // the remaining size of a job only grows here, so move it backwards
+  Jobs &jobs = m_channels[i->second.first].jobs;
+  JobsI job = i->second.second;
+  JobsI position = job;
+  ++position;
+  while (position != jobs.end () && position->remainSize <= job->remainSize)
+    {
+      ++position;
+    }
+  // splice keeps the iterator stored in the index valid
+  jobs.splice (position, jobs, job);
+}
+
+void
+ServiceChannelAllocator::EraseJob (VehicleIndexI i)
+{
+  uint32_t index = i->second.first;
+  ServiceChannel &channel = m_channels[index];
+  uint32_t oldJobs = channel.jobCount;
+  channel.jobs.erase (i->second.second);
+  channel.jobCount--;
+  m_vehicles.erase (i);
+  UpdateLoad (index, oldJobs, channel.remainTime);
+}
+
+void
+ServiceChannelAllocator::AddRemainTime (uint32_t index, uint32_t slots)
+{
+  ServiceChannel &channel = m_channels[index];
+  uint32_t oldTime = channel.remainTime;
+  channel.remainTime += slots;
+  UpdateLoad (index, channel.jobCount, oldTime);
+}
+
+void
+ServiceChannelAllocator::RemoveRemainTime (uint32_t index, uint32_t slots)
+{
+  ServiceChannel &channel = m_channels[index];
+  uint32_t oldTime = channel.remainTime;
+  // the service time of a job whose chunks were lost may be corrected
+  // by a smaller amount than it was estimated, so never wrap around.
+  channel.remainTime = channel.remainTime > slots ? channel.remainTime - slots : 0;
+  UpdateLoad (index, channel.jobCount, oldTime);
+}
+
+bool
+ServiceChannelAllocator::Contains (const Address &vehicle) const
+{
+  return m_vehicles.find (vehicle) != m_vehicles.end ();
+}
+
+uint32_t
+ServiceChannelAllocator::AllocServiceChannel (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!m_channels.empty ());
+  uint32_t index = 0;
+  switch (m_policy)
+    {
+    case SJF_ALLOCATION:
+      index = m_timeHeap.begin ()->second;
+      break;
+    case LEAST_LOADED_ALLOCATION:
+      index = m_jobHeap.begin ()->second;
+      break;
+    case ROUND_ROBIN_ALLOCATION:
+      if (m_next >= m_channels.size ())
+        {
+          m_next = 0;
+        }
+      index = m_next++;
+      break;
+    default:
+      NS_FATAL_ERROR ("unknown allocation policy " << m_policy);
+    }
+  return index;
+}
+
+uint32_t
+ServiceChannelAllocator::Enqueue (const Address &vehicle, uint32_t serviceSize)
+{
+  NS_LOG_FUNCTION (this << vehicle << serviceSize);
+  uint32_t queued = GetServiceChannel (vehicle);
+  if (queued != 0)
+    {
+      NS_LOG_DEBUG ("the request of " << vehicle << " is already queued on channel " << queued);
+      return queued;
+    }
+
+  uint32_t index = AllocServiceChannel ();
+  PushJob (index, ServiceJob (vehicle, serviceSize), true);
+  AddRemainTime (index, CalculateServiceTime (serviceSize));
+  return m_channels[index].channelNumber;
+}
+
+void
+ServiceChannelAllocator::EnqueueRemains (uint32_t channelNumber, uint32_t remainSize, const Address &vehicle)
+{
+  NS_LOG_FUNCTION (this << channelNumber << remainSize << vehicle);
+  uint32_t index = GetIndex (channelNumber);
+  if (index == m_channels.size ())
+    {
+      NS_LOG_DEBUG ("channel " << channelNumber << " is not a service channel of this allocator");
+      return;
+    }
+
+  Jobs &jobs = m_channels[index].jobs;
+  VehicleIndexI i = m_vehicles.find (vehicle);
+  if (i != m_vehicles.end ())
+    {
+      // a vehicle has at most one queued job, which will be served in turn.
+      // In FIFO order only the head job can have chunks waiting for a
+      // confirmation, while in SRPT order it may have been preempted.
+      if (i->second.first != index
+          || (m_order == FIFO_ORDER && i->second.second != jobs.begin ()))
+        {
+          return;
+        }
+      ServiceJob &job = *i->second.second;
+      if (job.remainSize < remainSize)
+        {
+          // some chunks sent in the last interval were lost
+          AddRemainTime (index, CalculateServiceTime (remainSize) - CalculateServiceTime (job.remainSize));
+          job.remainSize = remainSize;
+          SortJob (i);
+        }
+      job.sentSize = 0;
+      return;
+    }
+
+  // the RSU finished the job, but the vehicle did not receive all the chunks
+  if (m_order == FIFO_ORDER && !jobs.empty () && jobs.front ().sentSize != 0)
+    {
+      // the head job waits for a confirmation, so serve this vehicle later
+      m_backups.push_back (std::make_pair (index, ServiceJob (vehicle, remainSize)));
+    }
+  else
+    {
+      PushJob (index, ServiceJob (vehicle, remainSize), false);
+      AddRemainTime (index, CalculateServiceTime (remainSize));
+    }
+}
+
+void
+ServiceChannelAllocator::PushBackups (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_backups.empty ())
+    {
+      std::pair<uint32_t, ServiceJob> backup = m_backups.front ();
+      m_backups.pop_front ();
+      if (Contains (backup.second.vehicle))
+        {
+          // the vehicle has requested the service again in the meantime
+          continue;
+        }
+      PushJob (backup.first, backup.second, false);
+      AddRemainTime (backup.first, CalculateServiceTime (backup.second.remainSize));
+    }
+}
+
+void
+ServiceChannelAllocator::DropService (uint32_t channelNumber, const Address &vehicle)
+{
+  NS_LOG_FUNCTION (this << channelNumber << vehicle);
+  uint32_t index = GetIndex (channelNumber);
+  if (index == m_channels.size ())
+    {
+      return;
+    }
+  VehicleIndexI i = m_vehicles.find (vehicle);
+  if (i == m_vehicles.end () || i->second.first != index)
+    {
+      return;
+    }
+  uint32_t slots = CalculateServiceTime (i->second.second->remainSize);
+  EraseJob (i);
+  RemoveRemainTime (index, slots);
+}
+
+std::list<std::pair<uint32_t, ServiceJob> >
+ServiceChannelAllocator::Rebalance (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::list<std::pair<uint32_t, ServiceJob> > migrations;
+  for (uint32_t idle = 0; idle != m_channels.size (); ++idle)
+    {
+      if (!m_channels[idle].jobs.empty ())
+        {
+          continue;
+        }
+      // search the most backlogged channel which has a job to give away
+      for (ChannelHeap::reverse_iterator i = m_timeHeap.rbegin (); i != m_timeHeap.rend (); ++i)
+        {
+          uint32_t busy = i->second;
+          Jobs &jobs = m_channels[busy].jobs;
+          if (m_channels[busy].jobCount < 2)
+            {
+              continue;
+            }
+          JobsI job = --jobs.end ();
+          while (job != jobs.begin () && job->sentSize != 0)
+            {
+              --job;
+            }
+          if (job == jobs.begin ())
+            {
+              continue;
+            }
+          ServiceJob migration = *job;
+          NS_LOG_DEBUG ("move the job of " << migration.vehicle << " from channel "
+                        << m_channels[busy].channelNumber << " to channel " << m_channels[idle].channelNumber);
+          uint32_t slots = CalculateServiceTime (migration.remainSize);
+          EraseJob (m_vehicles.find (migration.vehicle));
+          RemoveRemainTime (busy, slots);
+          PushJob (idle, migration, true);
+          AddRemainTime (idle, slots);
+          migrations.push_back (std::make_pair (m_channels[idle].channelNumber, migration));
+          break;
+        }
+    }
+  return migrations;
+}
+
+bool
+ServiceChannelAllocator::IsEmpty (uint32_t channelNumber) const
+{
+  uint32_t index = GetIndex (channelNumber);
+  if (index == m_channels.size ())
+    {
+      return true;
+    }
+  return m_channels[index].jobs.empty ();
+}
+
+ServiceJob
+ServiceChannelAllocator::Peek (uint32_t channelNumber) const
+{
+  uint32_t index = GetIndex (channelNumber);
+  NS_ASSERT (index != m_channels.size () && !m_channels[index].jobs.empty ());
+  return m_channels[index].jobs.front ();
+}
+
+void
+ServiceChannelAllocator::Update (uint32_t channelNumber, uint32_t sentSize)
+{
+  NS_LOG_FUNCTION (this << channelNumber << sentSize);
+  uint32_t index = GetIndex (channelNumber);
+  NS_ASSERT (index != m_channels.size () && !m_channels[index].jobs.empty ());
+  ServiceJob &head = m_channels[index].jobs.front ();
+  NS_ASSERT (head.remainSize >= sentSize);
+  // several chunks may be sent in one SCH interval, so the service time
+  // is reduced by the intervals the sent bytes stand for.
+  uint32_t slots = CalculateServiceTime (head.remainSize);
+  head.remainSize -= sentSize;
+  head.sentSize += sentSize;
+  if (head.remainSize == 0)
+    {
+      EraseJob (m_vehicles.find (head.vehicle));
+    }
+  else
+    {
+      slots -= CalculateServiceTime (head.remainSize);
+    }
+  RemoveRemainTime (index, slots);
+}
+
+uint32_t
+ServiceChannelAllocator::GetServiceChannel (const Address &vehicle) const
+{
+  VehicleIndexCI i = m_vehicles.find (vehicle);
+  if (i == m_vehicles.end ())
+    {
+      return 0;
+    }
+  return m_channels[i->second.first].channelNumber;
+}
+
+uint32_t
+ServiceChannelAllocator::GetJobs (uint32_t channelNumber) const
+{
+  uint32_t index = GetIndex (channelNumber);
+  if (index == m_channels.size ())
+    {
+      return 0;
+    }
+  return m_channels[index].jobCount;
+}
+
+uint32_t
+ServiceChannelAllocator::GetRemainServiceTime (uint32_t channelNumber) const
+{
+  uint32_t index = GetIndex (channelNumber);
+  if (index == m_channels.size ())
+    {
+      return 0;
+    }
+  return m_channels[index].remainTime;
+}
+
+} // namespace ns3
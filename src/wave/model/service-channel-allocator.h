@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SERVICE_CHANNEL_ALLOCATOR_H
+#define SERVICE_CHANNEL_ALLOCATOR_H
+#include <list>
+#include <set>
+#include <vector>
+#include <stdint.h>
+#include "ns3/object.h"
+#include "ns3/address.h"
+#include "ns3/sgi-hashmap.h"
+#include "channel-manager.h"
+
+namespace ns3 {
+
+/**
+ * \param vehicle the address of the vehicle which requested the service
+ * \param remainSize the bytes of the service still to be delivered
+ * \param sentSize the bytes sent to the vehicle but not yet confirmed
+ *
+ * A service job is created for every WSA request admitted by a RSU,
+ * and stays in the queue of its service channel until all of its bytes
+ * are delivered or the vehicle gives up the service.
+ */
+struct ServiceJob
+{
+  Address vehicle;
+  uint32_t remainSize;
+  uint32_t sentSize;
+  ServiceJob ()
+    : remainSize (0),
+      sentSize (0)
+  {
+  }
+  ServiceJob (const Address &address, uint32_t remain, uint32_t sent = 0)
+    : vehicle (address),
+      remainSize (remain),
+      sentSize (sent)
+  {
+  }
+};
+
+/**
+ * \brief
+ * \ingroup wave
+ * This class allocates the service channels of a RSU to the service
+ * requests (WSAs) of vehicles and keeps one job queue per service channel.
+ *
+ * The channel of a new job is chosen by the allocation policy:
+ * 1) SJF_ALLOCATION, the job goes to the channel with the least remaining
+ * service time (the sum of the SCH intervals needed by all queued jobs);
+ * 2) ROUND_ROBIN_ALLOCATION, the channels are used in turn;
+ * 3) LEAST_LOADED_ALLOCATION, the job goes to the channel with the fewest
+ * queued jobs.
+ * The channels are kept in ordered sets keyed by their load, so a selection
+ * costs O(log n) with n channels instead of a scan over all queues.
+ * Every queued job is also indexed by the address of its vehicle, so the
+ * duplicate checks of Enqueue and EnqueueRemains and the lookup of
+ * DropService take constant time whatever the length of the queues.
+ *
+ * Inside a channel queue the jobs are served from the head chunk by chunk,
+ * see Update. The order of the queue is chosen by the service
+ * order:
+ * 1) FIFO_ORDER, jobs are served in the order they were admitted;
+ * 2) SRPT_ORDER, jobs are kept sorted by their remaining size, so a newly
+ * admitted short job preempts a long one at the next SCH interval.
+ */
+class ServiceChannelAllocator : public Object
+{
+public:
+  enum AllocationPolicy
+  {
+    SJF_ALLOCATION,
+    ROUND_ROBIN_ALLOCATION,
+    LEAST_LOADED_ALLOCATION,
+  };
+  enum ServiceOrder
+  {
+    FIFO_ORDER,
+    SRPT_ORDER,
+  };
+
+  static TypeId GetTypeId (void);
+  ServiceChannelAllocator (void);
+  virtual ~ServiceChannelAllocator (void);
+
+  /**
+   * \param channelNumber the SCH which will be used to serve vehicles
+   *
+   * the order in which channels are added is the order used by
+   * round robin allocation and the order used to break ties.
+   */
+  void AddServiceChannel (uint32_t channelNumber);
+  /**
+   * add all service channels known by ns3::ChannelManager.
+   */
+  void AddAllServiceChannels (void);
+  /**
+   * \return the service channels in the order they were added
+   */
+  std::vector<uint32_t> GetServiceChannels (void) const;
+
+  void SetPolicy (enum AllocationPolicy policy);
+  enum AllocationPolicy GetPolicy (void) const;
+  /**
+   * \param order the order in which the jobs of a channel are served
+   *
+   * the order shall be set before any job is queued.
+   */
+  void SetServiceOrder (enum ServiceOrder order);
+  enum ServiceOrder GetServiceOrder (void) const;
+
+  /**
+   * \param vehicle the vehicle which requests the service
+   * \param serviceSize the bytes of the requested service
+   * \return the service channel allocated to the request. If the vehicle
+   * already has a job queued, e.g. it repeats a request whose ACK was lost,
+   * no job is queued and the channel of its job is returned.
+   */
+  uint32_t Enqueue (const Address &vehicle, uint32_t serviceSize);
+  /**
+   * \param channelNumber the service channel which the vehicle was told to use
+   * \param remainSize the bytes the vehicle still waits for
+   * \param vehicle the vehicle which reports its remaining service
+   *
+   * Synchronize the queue with the view of the vehicle. A vehicle which is
+   * unknown to the queue (the RSU finished the job but the last chunk was lost)
+   * is queued again; a vehicle at the head of the queue whose last chunks were
+   * lost gets its remaining size corrected.
+   */
+  void EnqueueRemains (uint32_t channelNumber, uint32_t remainSize, const Address &vehicle);
+  /**
+   * requeue the jobs which were deferred by EnqueueRemains because
+   * the head job of their channel was waiting for a confirmation.
+   */
+  void PushBackups (void);
+  /**
+   * \param channelNumber the service channel of the job
+   * \param vehicle the vehicle which gives up the service
+   */
+  void DropService (uint32_t channelNumber, const Address &vehicle);
+  /**
+   * \return the migrated jobs, each with the service channel it is moved to
+   *
+   * Move jobs from backlogged channels to channels without any job, so no
+   * service channel stays idle while another one has a backlog. Every idle
+   * channel takes the last job with no chunk waiting for a confirmation from
+   * the channel with the most remaining service time; the head job of a
+   * channel is never moved. The caller shall tell the vehicles of the
+   * migrated jobs their new channels.
+   */
+  std::list<std::pair<uint32_t, ServiceJob> > Rebalance (void);
+
+  /**
+   * \param channelNumber the specific service channel
+   * \return whether no job is queued on the channel
+   */
+  bool IsEmpty (uint32_t channelNumber) const;
+  /**
+   * \param channelNumber the specific service channel
+   * \return the head job of the channel which shall not be empty
+   */
+  ServiceJob Peek (uint32_t channelNumber) const;
+  /**
+   * \param channelNumber the specific service channel
+   * \param sentSize the bytes of the head job sent as one chunk
+   *
+   * The head job is removed when all of its bytes are sent. Chunks of
+   * several jobs may be sent in one SCH interval.
+   */
+  void Update (uint32_t channelNumber, uint32_t sentSize);
+
+  /**
+   * \param vehicle the specific vehicle
+   * \return the service channel the job of the vehicle is queued on,
+   * or 0 if the vehicle has no queued job.
+   */
+  uint32_t GetServiceChannel (const Address &vehicle) const;
+  /**
+   * \param channelNumber the specific service channel
+   * \return the number of jobs queued on the channel
+   */
+  uint32_t GetJobs (uint32_t channelNumber) const;
+  /**
+   * \param channelNumber the specific service channel
+   * \return the SCH intervals still needed by the jobs queued on the channel
+   */
+  uint32_t GetRemainServiceTime (uint32_t channelNumber) const;
+  /**
+   * \param serviceSize the bytes of a service
+   * \return the number of SCH intervals needed to deliver the service
+   */
+  uint32_t CalculateServiceTime (uint32_t serviceSize) const;
+
+private:
+  virtual void DoDispose (void);
+
+  typedef std::list<ServiceJob> Jobs;
+  typedef std::list<ServiceJob>::iterator JobsI;
+  typedef std::list<ServiceJob>::const_iterator JobsCI;
+
+  struct ServiceChannel
+  {
+    uint32_t channelNumber;
+    Jobs jobs;
+    uint32_t jobCount;
+    uint32_t remainTime;
+  };
+
+  // the channel index and the queue position of the job of a vehicle
+  typedef sgi::hash_map<Address, std::pair<uint32_t, JobsI>, AddressHash> VehicleIndex;
+  typedef sgi::hash_map<Address, std::pair<uint32_t, JobsI>, AddressHash>::iterator VehicleIndexI;
+  typedef sgi::hash_map<Address, std::pair<uint32_t, JobsI>, AddressHash>::const_iterator VehicleIndexCI;
+
+  // the load of channels sorted in ascending order, the second value
+  // is the index of channel in m_channels to break ties.
+  typedef std::set<std::pair<uint32_t, uint32_t> > ChannelHeap;
+
+  uint32_t GetIndex (uint32_t channelNumber) const;
+  uint32_t AllocServiceChannel (void);
+  bool Contains (const Address &vehicle) const;
+  void PushJob (uint32_t index, const ServiceJob &job, bool back);
+  void EraseJob (VehicleIndexI i);
+  void SortJob (VehicleIndexI i);
+  void AddRemainTime (uint32_t index, uint32_t slots);
+  void RemoveRemainTime (uint32_t index, uint32_t slots);
+  void UpdateLoad (uint32_t index, uint32_t oldJobs, uint32_t oldTime);
+
+  std::vector<ServiceChannel> m_channels;
+  std::list<std::pair<uint32_t, ServiceJob> > m_backups;
+  VehicleIndex m_vehicles;
+
+  ChannelHeap m_timeHeap;
+  ChannelHeap m_jobHeap;
+
+  enum AllocationPolicy m_policy;
+  enum ServiceOrder m_order;
+  uint32_t m_next;
+  uint32_t m_serviceUnit;
+};
+
+}
+#endif /* SERVICE_CHANNEL_ALLOCATOR_H */
@@ -27,8 +27,8 @@
 #include "ns3/wifi-tx-vector.h"
 #include "ns3/wifi-mac-trailer.h"
 #include "ns3/object-map.h"
-#include <map>
 #include "channel-manager.h"
+#include "wave-mac-low.h"
 #include "wave-edca-txop-n.h"
 
 NS_LOG_COMPONENT_DEFINE ("WaveEdcaTxopN");
@@ -43,15 +43,20 @@ WaveEdcaTxopN::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::WaveEdcaTxopN")
     .SetParent<EdcaTxopN> ()
     .AddConstructor<WaveEdcaTxopN> ()
-    .AddAttribute ("Queues", "The WifiMacQueue object",
+    .AddAttribute ("Queues", "The WifiMacQueue objects of the channels used so far, in the order of the channel numbers.",
     				ObjectMapValue (),
-    				MakeObjectMapAccessor (&WaveEdcaTxopN::m_queues),
+    				MakeObjectMapAccessor (&WaveEdcaTxopN::GetChannelQueue,
+    				                       &WaveEdcaTxopN::GetNQueues),
     				MakeObjectMapChecker<WifiMacQueue> ())
   ;
   return tid;
 }
 
 WaveEdcaTxopN::WaveEdcaTxopN ()
+  : m_profile (&m_profiles[(CCH - CH172) / 2]),
+    m_defaultMinCw (0),
+    m_defaultMaxCw (0),
+    m_defaultAifsn (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -64,7 +69,10 @@ void
 WaveEdcaTxopN::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_queues.clear ();
+  for (uint32_t i = 0; i < CHANNELS_OF_WAVE; i++)
+    {
+      m_profiles[i].queue = 0;
+    }
   EdcaTxopN::DoDispose ();
 }
 void
@@ -72,8 +80,8 @@ WaveEdcaTxopN::DoInitialize (void)
 {
   NS_LOG_FUNCTION (this);
   EdcaTxopN::DoInitialize ();
-  m_queues.insert (std::make_pair (CCH, CreateObject<WifiMacQueue> ()));
-  m_queue = m_queues.find (CCH)->second;
+  ApplyProfile (m_profile->edca, GetProfile (CCH));
+  m_queue = m_profile->queue;
   m_baManager->SetQueue (m_queue);
   m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
 }
@@ -96,6 +104,61 @@ WaveEdcaTxopN::NotifyChannelSwitching (void)
   }
 }
 
+void
+WaveEdcaTxopN::NotifyAccessGranted (void)
+{
+  NS_LOG_FUNCTION (this);
+  // A packet which does not end before the guard interval is not sent by
+  // WaveMacLow and holds the channel access until the channel switch, so
+  // send the first packet of the queue which does end before it instead.
+  if (m_currentPacket == 0 && !m_baManager->HasPackets () && !m_queue->IsEmpty ())
+    {
+      WifiMacHeader hdr;
+      Ptr<const Packet> packet = m_queue->Peek (&hdr);
+      if (packet != 0 && !CanTransmitNow (packet, &hdr)
+          && !m_queue->MoveToFront (MakeCallback (&WaveEdcaTxopN::CanTransmitNow, this)))
+        {
+          NS_LOG_DEBUG ("no packet can be sent before the guard interval");
+          return;
+        }
+    }
+  EdcaTxopN::NotifyAccessGranted ();
+}
+
+bool
+WaveEdcaTxopN::CanTransmitNow (Ptr<const Packet> packet, const WifiMacHeader *hdr)
+{
+  Ptr<WaveMacLow> low = DynamicCast<WaveMacLow> (Low ());
+  if (low == 0)
+    {
+      return true;
+    }
+  // the frame which EdcaTxopN::NotifyAccessGranted would send first:
+  // the A-MSDU of the packet, or the first fragment of the packet, which
+  // the parameters extend with the next fragment
+  WifiMacHeader frameHdr = *hdr;
+  Ptr<const Packet> frame = packet;
+  if (!IsFragmented (packet, *hdr))
+    {
+      frame = AggregateMsdus (packet, &frameHdr, false);
+    }
+  MacLowTransmissionParameters params = GetTransmissionParameters (frame, frameHdr, 0);
+  if (IsFragmented (frame, frameHdr))
+    {
+      frameHdr.SetFragmentNumber (0);
+      if (params.HasNextPacket ())
+        {
+          frameHdr.SetMoreFragments ();
+        }
+      else
+        {
+          frameHdr.SetNoMoreFragments ();
+        }
+      frame = frame->CreateFragment (0, m_stationManager->GetFragmentSize (hdr->GetAddr1 (), hdr, packet, 0));
+    }
+  return low->CanTransmitNow (frame, &frameHdr, params);
+}
+
 void
 WaveEdcaTxopN::Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
@@ -113,18 +176,10 @@ WaveEdcaTxopN::Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       NS_FATAL_ERROR ("In WAVE, we should queue packet by qos and channel");
     }
 
-  WaveQueuesI i = m_queues.find (channelNumber);
-  if (i == m_queues.end ())
-    {
-	  std::pair<WaveQueuesI, bool> r = m_queues.insert (std::make_pair (channelNumber, CreateObject<WifiMacQueue> ()));
-	  NS_ASSERT (r.second == true);
-      i = r.first;
-    }
-
   WifiMacTrailer fcs;
   uint32_t fullPacketSize = hdr.GetSerializedSize () + packet->GetSize () + fcs.GetSerializedSize ();
   m_stationManager->PrepareForQueue (hdr.GetAddr1 (), &hdr, packet, fullPacketSize);
-  i->second->Enqueue (packet, hdr);
+  GetProfile (channelNumber)->queue->Enqueue (packet, hdr);
 
   if (m_queue->GetSize() != 0)
     {
@@ -135,19 +190,109 @@ WaveEdcaTxopN::Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 void
 WaveEdcaTxopN::SwitchToChannel (uint32_t channelNumber)
 {
-  NS_LOG_FUNCTION (this);
-  std::map<uint32_t,Ptr<WifiMacQueue> >::iterator i = m_queues.find (channelNumber);
-  if (i == m_queues.end ())
-    {
-      m_queues.insert (std::make_pair (channelNumber, CreateObject<WifiMacQueue> ()));
-      i = m_queues.find (channelNumber);
-    }
-  NS_ASSERT (i != m_queues.end ());
-  m_queue = i->second;
+  NS_LOG_FUNCTION (this << channelNumber);
+  ApplyProfile (m_profile->edca, GetProfile (channelNumber));
+  m_queue = m_profile->queue;
   m_baManager->SetQueue (m_queue);
   m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
 
   m_currentPacket = 0;
 }
 
+void
+WaveEdcaTxopN::SetChannelEdca (uint32_t channelNumber, uint32_t minCw, uint32_t maxCw, uint32_t aifsn)
+{
+  NS_LOG_FUNCTION (this << channelNumber << minCw << maxCw << aifsn);
+  ChannelProfile *profile = GetProfile (channelNumber);
+  bool ownEdca = m_profile->edca;
+  profile->edca = true;
+  profile->minCw = minCw;
+  profile->maxCw = maxCw;
+  profile->aifsn = aifsn;
+  if (profile == m_profile)
+    {
+      ApplyProfile (ownEdca, profile);
+    }
+}
+
+void
+WaveEdcaTxopN::ResetChannelEdca (uint32_t channelNumber)
+{
+  NS_LOG_FUNCTION (this << channelNumber);
+  ChannelProfile *profile = GetProfile (channelNumber);
+  bool ownEdca = m_profile->edca;
+  profile->edca = false;
+  if (profile == m_profile)
+    {
+      ApplyProfile (ownEdca, profile);
+    }
+}
+
+WaveEdcaTxopN::ChannelProfile *
+WaveEdcaTxopN::GetProfile (uint32_t channelNumber)
+{
+  NS_ASSERT (ChannelManager::IsWaveChannel (channelNumber));
+  ChannelProfile *profile = &m_profiles[(channelNumber - CH172) / 2];
+  if (profile->queue == 0)
+    {
+      profile->queue = CreateObject<WifiMacQueue> ();
+    }
+  return profile;
+}
+
+uint32_t
+WaveEdcaTxopN::GetNQueues (void) const
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < CHANNELS_OF_WAVE; i++)
+    {
+      if (m_profiles[i].queue != 0)
+        {
+          n++;
+        }
+    }
+  return n;
+}
+
+Ptr<WifiMacQueue>
+WaveEdcaTxopN::GetChannelQueue (uint32_t i) const
+{
+  for (uint32_t j = 0; j < CHANNELS_OF_WAVE; j++)
+    {
+      if (m_profiles[j].queue != 0 && i-- == 0)
+        {
+          return m_profiles[j].queue;
+        }
+    }
+  NS_ASSERT (false);
+  return 0;
+}
+
+void
+WaveEdcaTxopN::ApplyProfile (bool ownEdca, ChannelProfile *profile)
+{
+  if (profile->edca)
+    {
+      if (!ownEdca)
+        {
+          m_defaultMinCw = GetMinCw ();
+          m_defaultMaxCw = GetMaxCw ();
+          m_defaultAifsn = GetAifsn ();
+        }
+      if (GetMinCw () != profile->minCw || GetMaxCw () != profile->maxCw)
+        {
+          SetMinCw (profile->minCw);
+          SetMaxCw (profile->maxCw);
+        }
+      SetAifsn (profile->aifsn);
+    }
+  else if (ownEdca)
+    {
+      SetMinCw (m_defaultMinCw);
+      SetMaxCw (m_defaultMaxCw);
+      SetAifsn (m_defaultAifsn);
+    }
+  m_profile = profile;
+}
+
 } // namespace ns3
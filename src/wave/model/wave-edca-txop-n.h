@@ -27,7 +27,7 @@
 
 #include "ns3/edca-txop-n.h"
 #include "ns3/wifi-mac-queue.h"
-#include <map>
+#include "channel-manager.h"
 
 namespace ns3 {
 
@@ -100,11 +100,22 @@ private:
  *  A little different from operation declared by the standard, this class
  *  will calculate transmit time by considering many factors like RTS/CTS
  *  time, ACK time rather than the time of one MSDU frame.
+ *  When the channel access is granted and the frame at the head of the
+ *  queue would not end before the guard interval, the first frame of the
+ *  queue which would is sent instead, so that the end of the interval is
+ *  not left idle.
  * 3. chapter Channel routing
  * " the MAC shall route the packet to a proper queue corresponding to the
  * Channel Identifier and priority"
  * since wifi module only supports priority queue by QosTag, here we use
  * ChannelTag to find the final queue.
+ *
+ * Each WAVE channel has a profile with its queue and, optionally, EDCA
+ * parameters of its own, kept in an array indexed by channel. A channel
+ * switch makes the profile of the new channel current, and only sets the
+ * contention window and the AIFSN when the EDCA parameters of the two
+ * channels differ. The channels without EDCA parameters of their own use
+ * those set through EdcaTxopN, e.g. by OcbWifiMac::ConfigureEdca.
  */
 class WaveEdcaTxopN : public EdcaTxopN
 {
@@ -120,16 +131,92 @@ public:
     * if channel access is alternating access.
     */
   virtual void NotifyChannelSwitching (void);
+  /**
+   * With alternating access, move the first packet of the queue which
+   * can be sent before the guard interval to the front of the queue
+   * before dequeuing a packet, and dequeue no packet if none can.
+   */
+  virtual void NotifyAccessGranted (void);
 
   void SwitchToChannel (uint32_t channelNumber);
 
+  /**
+   * \param channelNumber the WAVE channel
+   * \param minCw the minimum contention window on the channel
+   * \param maxCw the maximum contention window on the channel
+   * \param aifsn the AIFSN on the channel
+   *
+   * Set the EDCA parameters of this access category on the channel,
+   * applied now if the channel is the current one.
+   */
+  void SetChannelEdca (uint32_t channelNumber, uint32_t minCw, uint32_t maxCw, uint32_t aifsn);
+  /**
+   * \param channelNumber the WAVE channel
+   *
+   * Use the default EDCA parameters on the channel again.
+   */
+  void ResetChannelEdca (uint32_t channelNumber);
+
 private:
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
 
-  typedef std::map<uint32_t, Ptr<WifiMacQueue> > WaveQueues;
-  typedef std::map<uint32_t,Ptr<WifiMacQueue> >::iterator WaveQueuesI;
-  WaveQueues m_queues;
+  /**
+   * The queue and the EDCA parameters of a channel.
+   */
+  struct ChannelProfile
+  {
+    ChannelProfile ()
+      : edca (false),
+        minCw (0),
+        maxCw (0),
+        aifsn (0)
+    {
+    }
+    // created on the first use of the channel
+    Ptr<WifiMacQueue> queue;
+    // whether the channel has EDCA parameters of its own
+    bool edca;
+    uint32_t minCw;
+    uint32_t maxCw;
+    uint32_t aifsn;
+  };
+
+  /**
+   * \param packet a packet of the queue
+   * \param hdr the header of the packet
+   * \return true if the packet can be sent before the guard interval, with
+   * the packets it would be aggregated with, or if it is fragmented, its
+   * first two fragments
+   */
+  bool CanTransmitNow (Ptr<const Packet> packet, const WifiMacHeader *hdr);
+
+  ChannelProfile * GetProfile (uint32_t channelNumber);
+  /**
+   * \return the number of channels which have a queue, for the Queues
+   * attribute
+   */
+  uint32_t GetNQueues (void) const;
+  /**
+   * \param i the index of the queue, lower than GetNQueues
+   * \return the queue of the i-th channel which has one, in the order
+   * of the channel numbers
+   */
+  Ptr<WifiMacQueue> GetChannelQueue (uint32_t i) const;
+  /**
+   * \param ownEdca whether the EDCA parameters in use are those of a
+   * channel rather than the default ones
+   * \param profile the profile to make current
+   */
+  void ApplyProfile (bool ownEdca, ChannelProfile *profile);
+
+  ChannelProfile m_profiles[CHANNELS_OF_WAVE];
+  ChannelProfile *m_profile;
+  // the EDCA parameters of the channels without their own, saved while
+  // the current channel has its own
+  uint32_t m_defaultMinCw;
+  uint32_t m_defaultMaxCw;
+  uint32_t m_defaultAifsn;
 };
 
 }  // namespace ns3
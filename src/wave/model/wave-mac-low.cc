@@ -53,7 +53,6 @@ WaveMacLow::SetWaveDevice (Ptr<NetDevice> device)
 {
   Ptr<WaveNetDevice> wave = DynamicCast<WaveNetDevice> (device);
   m_scheduler =  wave->GetChannelScheduler ();
-  m_coordinator =  wave->GetChannelCoordinator ();
 }
 
 WifiTxVector
@@ -101,28 +100,34 @@ WaveMacLow::StartTransmission (Ptr<const Packet> packet,
 {
   NS_LOG_FUNCTION (this << packet << hdr << params << listener);
   // if current channel access is not AlternatingAccess, just do as MacLow.
-  if (m_scheduler->GetAccess () != AlternatingAccess)
+  // Otherwise the packet is only sent if it ends before the guard interval.
+  if (CanTransmitNow (packet, hdr, params))
     {
-	  MacLow::StartTransmission (packet, hdr, params, listener);
-	  return;
+      MacLow::StartTransmission (packet, hdr, params, listener);
     }
-
-  Time transmissionTime = MacLow::CalculateTransmissionTime (packet, hdr, params);
-  Time remainingTime = m_coordinator->NeedTimeToGuardInterval ();
-
-  if (transmissionTime > remainingTime)
+  else
     {
-	  // this packet will not be delivered to PHY layer
-	  // and the data packet and management frame will be re-inserted into the queue by EdcaTxopN class
+      // this packet will not be delivered to PHY layer
+      // and the data packet and management frame will be re-inserted into the queue by EdcaTxopN class
+      NS_LOG_DEBUG ("this packet will be queued again.");
+    }
+}
 
-	  NS_LOG_DEBUG ("transmission time = " << transmissionTime
-			  	   << ", remainingTime = " << remainingTime
-				   << ", this packet will be queued again.");
-	 }
-  else
+bool
+WaveMacLow::CanTransmitNow (Ptr<const Packet> packet,
+                            const WifiMacHeader* hdr,
+                            const MacLowTransmissionParameters& params) const
+{
+  if (m_scheduler->GetAccess () != AlternatingAccess)
     {
-	  MacLow::StartTransmission (packet, hdr, params, listener);
+      return true;
     }
+  Time transmissionTime = MacLow::CalculateTransmissionTime (packet, hdr, params);
+  // the coordinator of the scheduler, which the device may replace
+  Time remainingTime = m_scheduler->GetChannelCoordinator ()->NeedTimeToGuardInterval ();
+  NS_LOG_DEBUG ("transmission time = " << transmissionTime
+                << ", remainingTime = " << remainingTime);
+  return transmissionTime <= remainingTime;
 }
 
 } // namespace ns3
@@ -50,10 +50,20 @@ public:
                           const WifiMacHeader* hdr,
                           MacLowTransmissionParameters parameters,
                           MacLowTransmissionListener *listener);
+  /**
+   * \param packet the packet to send
+   * \param hdr the header of the packet
+   * \param parameters the transmission parameters of the packet
+   * \return true if the packet can be sent now, i.e. the channel access
+   * is not alternating access or the whole transmission ends before
+   * the next guard interval.
+   */
+  bool CanTransmitNow (Ptr<const Packet> packet,
+                       const WifiMacHeader* hdr,
+                       const MacLowTransmissionParameters& parameters) const;
 private:
   virtual WifiTxVector GetDataTxVector (Ptr<const Packet> packet, const WifiMacHeader *hdr) const;
   Ptr<ChannelScheduler> m_scheduler;
-  Ptr<ChannelCoordinator> m_coordinator;
 };
 
 } // namespace ns3
@@ -57,12 +57,23 @@ WaveNetDevice::GetTypeId (void)
     		       MakeBooleanAccessor (&WaveNetDevice::SetIpOnCchSupported,
     		    		                &WaveNetDevice::GetIpOnCchSupported),
     		       MakeBooleanChecker ())
+    .AddAttribute ("SharedChannelCoordinator",
+                   "If true, the device uses the ChannelCoordinator shared by the devices "
+                   "of the nodes with the same system id rather than its own one. "
+                   "This shall be false for the devices which model a clock offset. "
+                   "The slot events of the shared coordinator run in the context of the "
+                   "first node which initializes it, whichever device they notify.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WaveNetDevice::SetSharedChannelCoordinator,
+                                        &WaveNetDevice::GetSharedChannelCoordinator),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 WaveNetDevice::WaveNetDevice (void)
   : m_txProfile (0),
+  m_sharedCoordinator (false),
   m_Scheduled (0),
   m_Size (0),
   m_Sent (false),
@@ -96,7 +107,10 @@ WaveNetDevice::DoDispose (void)
       delete m_txProfile;
       m_txProfile = 0;
     }
-  m_channelCoordinator->Dispose ();
+  if (!m_channelCoordinator->IsShared ())
+    {
+      m_channelCoordinator->Dispose ();
+    }
   m_channelManager->Dispose ();
   m_channelScheduler->Dispose ();
   m_vsaRepeater->Dispose ();
@@ -386,7 +400,17 @@ WaveNetDevice::GetChannelScheduler (void) const
 void
 WaveNetDevice::SetChannelCoordinator (Ptr<ChannelCoordinator> channelCoordinator)
 {
+  NS_LOG_FUNCTION (this << channelCoordinator);
+  if (m_channelCoordinator == channelCoordinator)
+    {
+      return;
+    }
+  if (!m_channelCoordinator->IsShared ())
+    {
+      m_channelCoordinator->Dispose ();
+    }
   m_channelCoordinator = channelCoordinator;
+  m_channelScheduler->SetChannelCoodinator (channelCoordinator);
 }
 
 Ptr<ChannelCoordinator>
@@ -395,6 +419,43 @@ WaveNetDevice::GetChannelCoordinator (void) const
   return m_channelCoordinator;
 }
 
+void
+WaveNetDevice::SetSharedChannelCoordinator (bool shared)
+{
+  NS_LOG_FUNCTION (this << shared);
+  m_sharedCoordinator = shared;
+  if (GetNode () == 0)
+    {
+      // the coordinator is chosen when the device is added to its node
+      return;
+    }
+  if (shared)
+    {
+      SetChannelCoordinator (ChannelCoordinator::GetShared (GetNode ()->GetSystemId ()));
+    }
+  else if (m_channelCoordinator->IsShared ())
+    {
+      SetChannelCoordinator (CreateObject<ChannelCoordinator> ());
+    }
+}
+
+bool
+WaveNetDevice::GetSharedChannelCoordinator (void) const
+{
+  return m_sharedCoordinator;
+}
+
+void
+WaveNetDevice::SetNode (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  WifiNetDevice::SetNode (node);
+  if (m_sharedCoordinator)
+    {
+      SetChannelCoordinator (ChannelCoordinator::GetShared (node->GetSystemId ()));
+    }
+}
+
 bool
 WaveNetDevice::IsLinkUp (void) const
 {
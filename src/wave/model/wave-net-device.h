@@ -269,8 +269,27 @@ public:
   Ptr<ChannelManager> GetChannelManager (void) const;
   void SetChannelScheduler (Ptr<ChannelScheduler> channelScheduler);
   Ptr<ChannelScheduler> GetChannelScheduler (void) const;
+  /**
+   * \param channelCoordinator the coordinator of the channel intervals of the device
+   *
+   * The previous coordinator is disposed of unless it is shared, and the
+   * channel scheduler and the MAC of the device use the new one. If the
+   * device is already initialized, so is the new coordinator, which shall
+   * then be set at the start of a sync interval.
+   */
   void SetChannelCoordinator (Ptr<ChannelCoordinator> channelCoordinator);
   Ptr<ChannelCoordinator> GetChannelCoordinator (void) const;
+  /**
+   * \param shared whether the device uses ChannelCoordinator::GetShared
+   * for the system id of its node rather than its own coordinator
+   *
+   * This shall be set before the device is initialized, or at the start
+   * of a sync interval, see SetChannelCoordinator.
+   */
+  void SetSharedChannelCoordinator (bool shared);
+  bool GetSharedChannelCoordinator (void) const;
+
+  virtual void SetNode (Ptr<Node> node);
 
   bool IsScheduled(void) const;
   void SetSchedule(uint32_t channelNumber, uint32_t serviceSize);
@@ -294,6 +313,7 @@ private:
   Ptr<ChannelCoordinator> m_channelCoordinator;
   Ptr<VsaRepeater> m_vsaRepeater;
   TxProfile *m_txProfile;
+  bool m_sharedCoordinator;
 
   bool m_ipOnCch;
   uint32_t m_Scheduled;
@@ -28,13 +28,21 @@
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/flow-id-tag.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/mac48-address.h"
+#include "ns3/pointer.h"
+#include "ns3/edca-txop-n.h"
 #include <iostream>
+#include <vector>
 
 #include "ns3/channel-coordinator.h"
 #include "ns3/channel-manager.h"
 #include "ns3/wave-net-device.h"
 #include "ns3/wave-mac-helper.h"
 #include "ns3/wave-helper.h"
+#include "ns3/service-channel-allocator.h"
 
 using namespace ns3;
 
@@ -215,6 +223,259 @@ public:
   }
   ChannelCoordinationTestCase *m_coordinatorTest;
 };
+// This test case tests the channel coordinator shared by the devices:
+// - the devices with the SharedChannelCoordinator attribute use the same
+//   coordinator, and the other ones keep their own coordinator
+// - the shared coordinator notifies its own listeners and drives the
+//   channel switches of the devices
+// - a device which leaves the shared coordinator while the simulation
+//   runs is driven by its new coordinator.
+class SharedChannelCoordinationTestCase : public TestCase
+{
+public:
+  SharedChannelCoordinationTestCase (void);
+  virtual ~SharedChannelCoordinationTestCase (void);
+
+private:
+  class CountingListener : public ChannelCoordinationListener
+  {
+  public:
+    CountingListener (void) : cchSlots (0), schSlots (0), guardSlots (0) {}
+    virtual void NotifyCchSlotStart (Time duration) { cchSlots++; }
+    virtual void NotifySchSlotStart (Time duration) { schSlots++; }
+    virtual void NotifyGuardSlotStart (Time duration, bool cchi) { guardSlots++; }
+    uint32_t cchSlots;
+    uint32_t schSlots;
+    uint32_t guardSlots;
+  };
+  void CheckChannel (Ptr<WaveNetDevice> device, uint16_t channelNumber);
+  void CheckCoordinator (Ptr<WaveNetDevice> device);
+  virtual void DoRun (void);
+};
+SharedChannelCoordinationTestCase::SharedChannelCoordinationTestCase (void)
+  : TestCase ("test channel coordinator shared by the devices")
+{
+}
+SharedChannelCoordinationTestCase::~SharedChannelCoordinationTestCase (void)
+{
+}
+void
+SharedChannelCoordinationTestCase::CheckChannel (Ptr<WaveNetDevice> device, uint16_t channelNumber)
+{
+  NS_TEST_EXPECT_MSG_EQ (device->GetPhy ()->GetChannelNumber (), channelNumber,
+                         "now is " << Now ().GetMilliSeconds () << "ms");
+}
+void
+SharedChannelCoordinationTestCase::CheckCoordinator (Ptr<WaveNetDevice> device)
+{
+  NS_TEST_EXPECT_MSG_EQ (device->GetChannelCoordinator ()->IsShared (), false, "the device shall have left the shared coordinator");
+  NS_TEST_EXPECT_MSG_EQ (device->GetChannelScheduler ()->GetChannelCoordinator (), device->GetChannelCoordinator (),
+                         "the scheduler and the MAC shall use the new coordinator");
+}
+void
+SharedChannelCoordinationTestCase::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper wifiPhy =  YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WaveMacHelper waveMac = WaveMacHelper::Default ();
+  WaveHelper waveHelper = WaveHelper::Default ();
+  Config::SetDefault ("ns3::WaveNetDevice::SharedChannelCoordinator", BooleanValue (true));
+  NetDeviceContainer devices = waveHelper.Install (wifiPhy, waveMac, nodes);
+  Config::SetDefault ("ns3::WaveNetDevice::SharedChannelCoordinator", BooleanValue (false));
+
+  Ptr<WaveNetDevice> own = DynamicCast<WaveNetDevice> (devices.Get (0));
+  Ptr<WaveNetDevice> cch = DynamicCast<WaveNetDevice> (devices.Get (1));
+  Ptr<WaveNetDevice> alternating = DynamicCast<WaveNetDevice> (devices.Get (2));
+  own->SetSharedChannelCoordinator (false);
+  Ptr<ChannelCoordinator> shared = ChannelCoordinator::GetShared ();
+  NS_TEST_EXPECT_MSG_EQ (shared->IsShared (), true, "the coordinator of GetShared shall be shared");
+  NS_TEST_EXPECT_MSG_EQ (cch->GetChannelCoordinator (), shared, "the device shall use the shared coordinator");
+  NS_TEST_EXPECT_MSG_EQ (alternating->GetChannelCoordinator (), shared, "the device shall use the shared coordinator");
+  NS_TEST_EXPECT_MSG_EQ ((own->GetChannelCoordinator () != shared), true, "the device shall keep its own coordinator");
+  NS_TEST_EXPECT_MSG_EQ (own->GetChannelCoordinator ()->IsShared (), false, "the device shall keep its own coordinator");
+
+  CountingListener listener;
+  shared->RegisterListener (&listener);
+  Simulator::Schedule (Seconds (0), &WaveNetDevice::StartSch, alternating, SchInfo (SCH1, false, 0));
+  Simulator::Schedule (Seconds (0), &WaveNetDevice::StartSch, cch, SchInfo (CCH, false, 0xff));
+  Simulator::Schedule (MilliSeconds (30), &SharedChannelCoordinationTestCase::CheckChannel, this, alternating, CCH);
+  Simulator::Schedule (MilliSeconds (80), &SharedChannelCoordinationTestCase::CheckChannel, this, alternating, SCH1);
+  Simulator::Schedule (MilliSeconds (80), &SharedChannelCoordinationTestCase::CheckChannel, this, cch, CCH);
+  Simulator::Schedule (MilliSeconds (130), &SharedChannelCoordinationTestCase::CheckChannel, this, alternating, CCH);
+  // at the start of a sync interval, before the slot event of the shared coordinator
+  Simulator::Schedule (MilliSeconds (200), &WaveNetDevice::SetSharedChannelCoordinator, alternating, false);
+  Simulator::Schedule (MilliSeconds (201), &SharedChannelCoordinationTestCase::CheckCoordinator, this, alternating);
+  Simulator::Schedule (MilliSeconds (230), &SharedChannelCoordinationTestCase::CheckChannel, this, alternating, CCH);
+  Simulator::Schedule (MilliSeconds (280), &SharedChannelCoordinationTestCase::CheckChannel, this, alternating, SCH1);
+  Simulator::Schedule (MilliSeconds (280), &SharedChannelCoordinationTestCase::CheckChannel, this, cch, CCH);
+  Simulator::Schedule (MilliSeconds (330), &SharedChannelCoordinationTestCase::CheckChannel, this, alternating, CCH);
+  Simulator::Stop (MilliSeconds (990));
+  Simulator::Run ();
+  // the slots start at 0ms, 4ms, 50ms, 54ms, 100ms, ... 950ms and 954ms
+  NS_TEST_EXPECT_MSG_EQ (listener.guardSlots, 20, "one notification per guard slot");
+  NS_TEST_EXPECT_MSG_EQ (listener.cchSlots, 10, "one notification per CCH slot");
+  NS_TEST_EXPECT_MSG_EQ (listener.schSlots, 10, "one notification per SCH slot");
+  Simulator::Destroy ();
+
+  // the shared coordinators are released with the simulation
+  NS_TEST_EXPECT_MSG_EQ ((ChannelCoordinator::GetShared () != shared), true, "the shared coordinator shall be released");
+  Simulator::Destroy ();
+}
+
+// This test case tests the EDCA parameters of a service channel.
+// In particular, it checks the following:
+// - the EDCA parameters of StartSch apply in the SCH intervals of
+//   alternating access, and the default ones in the CCH intervals
+// - the access categories missing from the parameters keep the default ones
+// - the default parameters apply again once the channel is released.
+class ChannelEdcaTestCase : public TestCase
+{
+public:
+  ChannelEdcaTestCase (void);
+  virtual ~ChannelEdcaTestCase (void);
+
+private:
+  void CheckEdca (Ptr<EdcaTxopN> edca, uint32_t minCw, uint32_t maxCw, uint32_t aifsn);
+  virtual void DoRun (void);
+};
+ChannelEdcaTestCase::ChannelEdcaTestCase (void)
+  : TestCase ("test EDCA parameters of service channels")
+{
+}
+ChannelEdcaTestCase::~ChannelEdcaTestCase (void)
+{
+}
+void
+ChannelEdcaTestCase::CheckEdca (Ptr<EdcaTxopN> edca, uint32_t minCw, uint32_t maxCw, uint32_t aifsn)
+{
+  NS_TEST_EXPECT_MSG_EQ (edca->GetMinCw (), minCw, "now is " << Now ().GetMilliSeconds () << "ms");
+  NS_TEST_EXPECT_MSG_EQ (edca->GetMaxCw (), maxCw, "now is " << Now ().GetMilliSeconds () << "ms");
+  NS_TEST_EXPECT_MSG_EQ (edca->GetAifsn (), aifsn, "now is " << Now ().GetMilliSeconds () << "ms");
+}
+void
+ChannelEdcaTestCase::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper wifiPhy =  YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WaveMacHelper waveMac = WaveMacHelper::Default ();
+  WaveHelper waveHelper = WaveHelper::Default ();
+  NetDeviceContainer devices = waveHelper.Install (wifiPhy, waveMac, nodes);
+  Ptr<WaveNetDevice> device = DynamicCast<WaveNetDevice> (devices.Get (0));
+
+  PointerValue ptr;
+  device->GetMac ()->GetAttribute ("BE_EdcaTxopN", ptr);
+  Ptr<EdcaTxopN> be = ptr.Get<EdcaTxopN> ();
+  device->GetMac ()->GetAttribute ("VI_EdcaTxopN", ptr);
+  Ptr<EdcaTxopN> vi = ptr.Get<EdcaTxopN> ();
+  uint32_t viMinCw = vi->GetMinCw ();
+  uint32_t viMaxCw = vi->GetMaxCw ();
+  uint32_t viAifsn = vi->GetAifsn ();
+
+  EdcaParameterSet edca;
+  EdcaParameter parameter;
+  parameter.cwmin = 31;
+  parameter.cwmax = 511;
+  parameter.aifsn = 4;
+  edca[AC_BE] = parameter;
+  Simulator::Schedule (Seconds (0), &WaveNetDevice::StartSch, device, SchInfo (SCH1, false, 0, edca));
+  Simulator::Schedule (MilliSeconds (30), &ChannelEdcaTestCase::CheckEdca, this, be, 15, 1023, 6);
+  Simulator::Schedule (MilliSeconds (80), &ChannelEdcaTestCase::CheckEdca, this, be, 31, 511, 4);
+  Simulator::Schedule (MilliSeconds (80), &ChannelEdcaTestCase::CheckEdca, this, vi, viMinCw, viMaxCw, viAifsn);
+  Simulator::Schedule (MilliSeconds (130), &ChannelEdcaTestCase::CheckEdca, this, be, 15, 1023, 6);
+  Simulator::Schedule (MilliSeconds (180), &ChannelEdcaTestCase::CheckEdca, this, be, 31, 511, 4);
+  Simulator::Schedule (MilliSeconds (190), &WaveNetDevice::StopSch, device, SCH1);
+  Simulator::Schedule (MilliSeconds (190), &ChannelEdcaTestCase::CheckEdca, this, be, 15, 1023, 6);
+  Simulator::Schedule (MilliSeconds (280), &ChannelEdcaTestCase::CheckEdca, this, be, 15, 1023, 6);
+  Simulator::Stop (MilliSeconds (300));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * With alternating access, a frame which does not end before the guard
+ * interval shall not hold up the smaller frames queued after it which do.
+ */
+class GuardIntervalFitTestCase : public TestCase
+{
+public:
+  GuardIntervalFitTestCase (void);
+  virtual ~GuardIntervalFitTestCase (void);
+
+private:
+  void Send (uint32_t size);
+  bool Receive (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender);
+  virtual void DoRun (void);
+  Ptr<WaveNetDevice> m_sender;
+  std::vector<uint32_t> m_sizes;
+  std::vector<Time> m_times;
+};
+GuardIntervalFitTestCase::GuardIntervalFitTestCase (void)
+  : TestCase ("test frames which end before the guard interval are sent before those which do not")
+{
+}
+GuardIntervalFitTestCase::~GuardIntervalFitTestCase (void)
+{
+}
+void
+GuardIntervalFitTestCase::Send (uint32_t size)
+{
+  m_sender->SendX (Create<Packet> (size), Mac48Address::GetBroadcast (), 0x80dd, TxInfo (CCH));
+}
+bool
+GuardIntervalFitTestCase::Receive (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address &sender)
+{
+  m_sizes.push_back (pkt->GetSize ());
+  m_times.push_back (Now ());
+  return true;
+}
+void
+GuardIntervalFitTestCase::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper wifiPhy =  YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WaveMacHelper waveMac = WaveMacHelper::Default ();
+  WaveHelper waveHelper = WaveHelper::Default ();
+  NetDeviceContainer devices = waveHelper.Install (wifiPhy, waveMac, nodes);
+  m_sender = DynamicCast<WaveNetDevice> (devices.Get (0));
+  Ptr<WaveNetDevice> receiver = DynamicCast<WaveNetDevice> (devices.Get (1));
+  receiver->SetReceiveCallback (MakeCallback (&GuardIntervalFitTestCase::Receive, this));
+
+  SchInfo info = SchInfo (SCH1, false, 0);
+  Simulator::Schedule (Seconds (0), &WaveNetDevice::StartSch, m_sender, info);
+  Simulator::Schedule (Seconds (0), &WaveNetDevice::StartSch, receiver, info);
+  // 1ms before the guard interval at the end of the first CCH interval,
+  // the large frame needs about 3ms at 6Mbps and the small one less than 1ms
+  Simulator::Schedule (MilliSeconds (49), &GuardIntervalFitTestCase::Send, this, 1000);
+  Simulator::Schedule (MilliSeconds (49), &GuardIntervalFitTestCase::Send, this, 100);
+  Simulator::Stop (MilliSeconds (200));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_sizes.size (), 2, "both frames shall be received");
+  NS_TEST_EXPECT_MSG_EQ (m_sizes[0], 100, "the small frame shall be sent first");
+  NS_TEST_EXPECT_MSG_LT (m_times[0], MilliSeconds (50), "the small frame shall be sent before the guard interval");
+  NS_TEST_EXPECT_MSG_EQ (m_sizes[1], 1000, "the large frame shall be sent next");
+  NS_TEST_EXPECT_MSG_GT (m_times[1], MilliSeconds (104), "the large frame shall be sent in the next CCH interval");
+}
+
 /**
  *  route different packets or frames
  *  see 1609.4-2010 chapter 5.3.4
@@ -773,6 +1034,223 @@ AlternatingAccessTestCase::DoRun ()
             << std::endl;
 }
 
+// This test case tests the allocation policies of ServiceChannelAllocator.
+// In particular, it checks the following:
+// - SJF allocates a new job to the channel with the least remaining service time
+// - round robin uses the channels in turn
+// - least loaded allocates a new job to the channel with the fewest jobs
+// - a vehicle can only have one queued job, on any channel
+class ServiceChannelAllocationTestCase : public TestCase
+{
+public:
+  ServiceChannelAllocationTestCase (void);
+  virtual ~ServiceChannelAllocationTestCase (void);
+private:
+  Ptr<ServiceChannelAllocator> CreateAllocator (enum ServiceChannelAllocator::AllocationPolicy policy);
+  virtual void DoRun (void);
+};
+
+ServiceChannelAllocationTestCase::ServiceChannelAllocationTestCase (void)
+  : TestCase ("test allocation policies of service channel allocator")
+{
+}
+ServiceChannelAllocationTestCase::~ServiceChannelAllocationTestCase (void)
+{
+}
+Ptr<ServiceChannelAllocator>
+ServiceChannelAllocationTestCase::CreateAllocator (enum ServiceChannelAllocator::AllocationPolicy policy)
+{
+  Ptr<ServiceChannelAllocator> allocator = CreateObject<ServiceChannelAllocator> ();
+  allocator->SetAttribute ("Policy", EnumValue (policy));
+  allocator->AddServiceChannel (SCH2);
+  allocator->AddServiceChannel (SCH3);
+  allocator->AddServiceChannel (SCH4);
+  return allocator;
+}
+void
+ServiceChannelAllocationTestCase::DoRun (void)
+{
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  Mac48Address b = Mac48Address ("00:00:00:00:00:02");
+  Mac48Address c = Mac48Address ("00:00:00:00:00:03");
+  Mac48Address d = Mac48Address ("00:00:00:00:00:04");
+
+  Ptr<ServiceChannelAllocator> sjf = CreateAllocator (ServiceChannelAllocator::SJF_ALLOCATION);
+  // with default ServiceUnit, 20000 bytes need 4 intervals, 1000 bytes need 1 interval.
+  NS_TEST_EXPECT_MSG_EQ (sjf->Enqueue (a, 20000), SCH2, "empty channels shall be used in added order");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Enqueue (b, 12000), SCH3, "SCH3 and SCH4 have no remaining service");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Enqueue (c, 1000), SCH4, "SCH4 has no remaining service");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Enqueue (d, 1000), SCH4, "SCH4 has the least remaining service");
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetRemainServiceTime (SCH2), 4, "20000 bytes need 4 intervals");
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetJobs (SCH4), 2, "two jobs are queued on SCH4");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Enqueue (a, 1000), SCH2, "a repeated request gets the channel of the queued job");
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetJobs (SCH2), 1, "a vehicle can only have one queued job");
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetRemainServiceTime (SCH2), 4, "a repeated request does not change the queued job");
+
+  // serve SCH2 until its job is finished
+  sjf->Update (SCH2, 6000);
+  sjf->Update (SCH2, 6000);
+  sjf->Update (SCH2, 6000);
+  NS_TEST_EXPECT_MSG_EQ (sjf->Peek (SCH2).remainSize, 2000, "18000 bytes of 20000 are sent");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Peek (SCH2).sentSize, 18000, "18000 bytes are waiting for a confirmation");
+  sjf->Update (SCH2, 2000);
+  NS_TEST_EXPECT_MSG_EQ (sjf->IsEmpty (SCH2), true, "the job of SCH2 is finished");
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetRemainServiceTime (SCH2), 0, "the remaining service time shall not wrap around");
+
+  // the vehicle lost the last chunk, so the job is queued again
+  sjf->EnqueueRemains (SCH2, 2000, a);
+  NS_TEST_EXPECT_MSG_EQ (sjf->IsEmpty (SCH2), false, "the lost chunk shall be served again");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Peek (SCH2).vehicle, Address (a), "the job of vehicle a is at the head");
+  sjf->DropService (SCH4, d);
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetJobs (SCH4), 1, "the job of vehicle d is dropped");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Peek (SCH4).vehicle, Address (c), "the job of vehicle c remains");
+  NS_TEST_EXPECT_MSG_EQ (sjf->Enqueue (d, 1000), SCH2, "a dropped vehicle can request the service again");
+  sjf->DropService (SCH3, d);
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetJobs (SCH2), 2, "the job of vehicle d is not queued on SCH3");
+  sjf->EnqueueRemains (SCH4, 1000, d);
+  NS_TEST_EXPECT_MSG_EQ (sjf->GetJobs (SCH4), 1, "vehicle d is already queued on SCH2");
+  sjf->Dispose ();
+
+  Ptr<ServiceChannelAllocator> rr = CreateAllocator (ServiceChannelAllocator::ROUND_ROBIN_ALLOCATION);
+  NS_TEST_EXPECT_MSG_EQ (rr->Enqueue (a, 20000), SCH2, "round robin starts from the first channel");
+  NS_TEST_EXPECT_MSG_EQ (rr->Enqueue (b, 20000), SCH3, "round robin uses channels in turn");
+  NS_TEST_EXPECT_MSG_EQ (rr->Enqueue (c, 20000), SCH4, "round robin uses channels in turn");
+  NS_TEST_EXPECT_MSG_EQ (rr->Enqueue (d, 20000), SCH2, "round robin wraps around");
+  rr->Dispose ();
+
+  Ptr<ServiceChannelAllocator> ll = CreateAllocator (ServiceChannelAllocator::LEAST_LOADED_ALLOCATION);
+  NS_TEST_EXPECT_MSG_EQ (ll->Enqueue (a, 20000), SCH2, "empty channels shall be used in added order");
+  NS_TEST_EXPECT_MSG_EQ (ll->Enqueue (b, 1000), SCH3, "SCH3 has no job");
+  ll->Update (SCH3, 1000);
+  NS_TEST_EXPECT_MSG_EQ (ll->Enqueue (c, 1000), SCH3, "SCH3 has no job again");
+  NS_TEST_EXPECT_MSG_EQ (ll->Enqueue (d, 1000), SCH4, "SCH4 has the fewest jobs");
+  ll->Dispose ();
+}
+
+// This test case tests the SRPT service order of ServiceChannelAllocator.
+// In particular, it checks the following:
+// - jobs of a channel are served by their remaining size
+// - a new short job preempts the head job at the next SCH interval
+// - a job whose chunks were lost is moved back by its remaining size
+class ServiceOrderTestCase : public TestCase
+{
+public:
+  ServiceOrderTestCase (void);
+  virtual ~ServiceOrderTestCase (void);
+private:
+  virtual void DoRun (void);
+};
+
+ServiceOrderTestCase::ServiceOrderTestCase (void)
+  : TestCase ("test SRPT service order of service channel allocator")
+{
+}
+ServiceOrderTestCase::~ServiceOrderTestCase (void)
+{
+}
+void
+ServiceOrderTestCase::DoRun (void)
+{
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  Mac48Address b = Mac48Address ("00:00:00:00:00:02");
+  Mac48Address c = Mac48Address ("00:00:00:00:00:03");
+
+  Ptr<ServiceChannelAllocator> srpt = CreateObject<ServiceChannelAllocator> ();
+  srpt->SetAttribute ("ServiceOrder", EnumValue (ServiceChannelAllocator::SRPT_ORDER));
+  srpt->AddServiceChannel (SCH2);
+
+  srpt->Enqueue (a, 20000);
+  srpt->Enqueue (b, 12000);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).vehicle, Address (b), "the shorter job shall be served first");
+  srpt->Update (SCH2, 6000);
+  srpt->Update (SCH2, 6000);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).vehicle, Address (a), "the job of vehicle b is finished");
+  srpt->Update (SCH2, 6000);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).remainSize, 14000, "6000 bytes of 20000 are sent");
+
+  srpt->Enqueue (c, 3000);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).vehicle, Address (c), "the short job preempts the long one");
+  srpt->Update (SCH2, 3000);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).vehicle, Address (a), "the preempted job is resumed");
+
+  // the preempted chunk of vehicle a was lost, which is reported after preemption
+  srpt->Enqueue (c, 16000);
+  srpt->EnqueueRemains (SCH2, 20000, a);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).vehicle, Address (c), "the job of vehicle a is moved back");
+  NS_TEST_EXPECT_MSG_EQ (srpt->GetJobs (SCH2), 2, "two jobs are queued");
+  srpt->Update (SCH2, 6000);
+  srpt->Update (SCH2, 6000);
+  srpt->Update (SCH2, 4000);
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).vehicle, Address (a), "the job of vehicle c is finished");
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).remainSize, 20000, "the lost chunk shall be served again");
+  NS_TEST_EXPECT_MSG_EQ (srpt->Peek (SCH2).sentSize, 0, "no chunk waits for a confirmation");
+  srpt->Dispose ();
+}
+
+// This test case tests the rebalancing of ServiceChannelAllocator.
+// In particular, it checks the following:
+// - an idle channel takes the last job of a backlogged channel
+// - the head job of a channel is never moved
+class ServiceRebalanceTestCase : public TestCase
+{
+public:
+  ServiceRebalanceTestCase (void);
+  virtual ~ServiceRebalanceTestCase (void);
+private:
+  virtual void DoRun (void);
+};
+
+ServiceRebalanceTestCase::ServiceRebalanceTestCase (void)
+  : TestCase ("test rebalancing of service channel allocator")
+{
+}
+ServiceRebalanceTestCase::~ServiceRebalanceTestCase (void)
+{
+}
+void
+ServiceRebalanceTestCase::DoRun (void)
+{
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  Mac48Address b = Mac48Address ("00:00:00:00:00:02");
+  Mac48Address c = Mac48Address ("00:00:00:00:00:03");
+  Mac48Address d = Mac48Address ("00:00:00:00:00:04");
+  Mac48Address e = Mac48Address ("00:00:00:00:00:05");
+
+  Ptr<ServiceChannelAllocator> allocator = CreateObject<ServiceChannelAllocator> ();
+  allocator->SetAttribute ("Policy", EnumValue (ServiceChannelAllocator::ROUND_ROBIN_ALLOCATION));
+  allocator->AddServiceChannel (SCH2);
+  allocator->AddServiceChannel (SCH3);
+  // SCH2 serves a, c and e, SCH3 serves b and d
+  allocator->Enqueue (a, 20000);
+  allocator->Enqueue (b, 1000);
+  allocator->Enqueue (c, 5000);
+  allocator->Enqueue (d, 2000);
+  allocator->Enqueue (e, 3000);
+  NS_TEST_EXPECT_MSG_EQ (allocator->Rebalance ().empty (), true, "no channel is idle");
+
+  allocator->Update (SCH2, 6000);
+  allocator->Update (SCH3, 1000);
+  allocator->Update (SCH3, 2000);
+  std::list<std::pair<uint32_t, ServiceJob> > migrations = allocator->Rebalance ();
+  NS_TEST_ASSERT_MSG_EQ (migrations.size (), 1, "idle SCH3 takes one job");
+  NS_TEST_EXPECT_MSG_EQ (migrations.front ().first, SCH3, "the job is moved to SCH3");
+  NS_TEST_EXPECT_MSG_EQ (migrations.front ().second.vehicle, Address (e), "the last job of SCH2 is moved");
+  NS_TEST_EXPECT_MSG_EQ (allocator->GetJobs (SCH2), 2, "SCH2 serves a and c");
+  NS_TEST_EXPECT_MSG_EQ (allocator->GetRemainServiceTime (SCH3), 1, "3000 bytes need 1 interval");
+  NS_TEST_EXPECT_MSG_EQ (allocator->GetServiceChannel (e), SCH3, "vehicle e is served by SCH3");
+  NS_TEST_EXPECT_MSG_EQ (allocator->Enqueue (e, 3000), SCH3, "the moved job is still indexed");
+  NS_TEST_EXPECT_MSG_EQ (allocator->GetJobs (SCH3), 1, "the moved job is not queued twice");
+
+  allocator->Update (SCH3, 3000);
+  migrations = allocator->Rebalance ();
+  NS_TEST_ASSERT_MSG_EQ (migrations.size (), 1, "idle SCH3 takes one job again");
+  NS_TEST_EXPECT_MSG_EQ (migrations.front ().second.vehicle, Address (c), "the job of vehicle c is moved");
+  allocator->Update (SCH3, 5000);
+  NS_TEST_EXPECT_MSG_EQ (allocator->Rebalance ().empty (), true, "the head job of SCH2 is never moved");
+  NS_TEST_EXPECT_MSG_EQ (allocator->GetServiceChannel (a), SCH2, "vehicle a is still served by SCH2");
+  NS_TEST_EXPECT_MSG_EQ (allocator->GetServiceChannel (b), 0, "the job of vehicle b is finished");
+  allocator->Dispose ();
+}
 class WaveTestSuite : public TestSuite
 {
 public:
@@ -784,6 +1262,12 @@ WaveTestSuite::WaveTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new ChannelCoordinationTestCase, TestCase::QUICK);
+  AddTestCase (new SharedChannelCoordinationTestCase, TestCase::QUICK);
+  AddTestCase (new ChannelEdcaTestCase, TestCase::QUICK);
+  AddTestCase (new GuardIntervalFitTestCase, TestCase::QUICK);
+  AddTestCase (new ServiceChannelAllocationTestCase, TestCase::QUICK);
+  AddTestCase (new ServiceOrderTestCase, TestCase::QUICK);
+  AddTestCase (new ServiceRebalanceTestCase, TestCase::QUICK);
   AddTestCase (new ChannelRoutingTestCase, TestCase::QUICK);
   AddTestCase (new ChannelAccessTestCase, TestCase::QUICK);
   AddTestCase (new AlternatingAccessTestCase, TestCase::QUICK);
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the cost of the receptions of broadcast frames, as sent by the
+// vehicles of a WAVE scenario: all the nodes are in range of each other
+// and broadcast a frame in turn, so each transmission is received by all
+// the other nodes. The memory allocations of the whole process are
+// counted while the simulation runs, and reported per reception, with
+// the receptions handed up to the devices and those lost to collisions
+// or to the state of the PHYs.
+//
+//   ./bench-broadcast-fanout --nodes=100 --frames=10
+
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+static uint64_t g_allocations = 0;
+
+void *
+operator new (std::size_t size) throw (std::bad_alloc)
+{
+  g_allocations++;
+  void *block = std::malloc (size == 0 ? 1 : size);
+  if (block == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return block;
+}
+
+void
+operator delete (void *block) throw ()
+{
+  if (block != 0)
+    {
+      std::free (block);
+    }
+}
+
+static uint64_t g_rxOk = 0;
+static uint64_t g_rxError = 0;
+static uint64_t g_rxUp = 0;
+
+static void
+RxOk (Ptr<const Packet> packet)
+{
+  g_rxOk++;
+}
+
+static void
+RxError (Ptr<const Packet> packet)
+{
+  g_rxError++;
+}
+
+static bool
+RxUp (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  g_rxUp++;
+  return true;
+}
+
+static void
+Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x88dc);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nodes = 100;
+  uint32_t frames = 10;
+  uint32_t size = 200;
+  double spacing = 5;
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "Number of nodes, all in range of each other.", nodes);
+  cmd.AddValue ("frames", "Frames broadcast by each node.", frames);
+  cmd.AddValue ("size", "Size of the frames, in bytes.", size);
+  cmd.AddValue ("spacing", "Distance between two neighbour nodes on a line, in meters.", spacing);
+  cmd.Parse (argc, argv);
+
+  NodeContainer c;
+  c.Create (nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (spacing),
+                                 "GridWidth", UintegerValue (nodes));
+  mobility.Install (c);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  NetDeviceContainer devices = wifi.Install (phy, mac, c);
+
+  // the frames are 2ms apart, so that each one is over before the next
+  // one is sent, and the receptions are mostly successful.
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (i));
+      device->SetReceiveCallback (MakeCallback (&RxUp));
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&RxOk));
+      device->GetPhy ()->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&RxError));
+      for (uint32_t j = 0; j < frames; j++)
+        {
+          Simulator::Schedule (Seconds (1) + MilliSeconds (2 * (j * nodes + i)), &Send, device, size);
+        }
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t allocations = g_allocations;
+  Simulator::Run ();
+  allocations = g_allocations - allocations;
+  int64_t elapsed = clock.End ();
+
+  uint64_t receptions = g_rxOk + g_rxError;
+  std::cout << receptions << " receptions in " << elapsed << "ms: "
+            << g_rxOk << " successful, " << g_rxError << " dropped, "
+            << g_rxUp << " handed up to the devices" << std::endl
+            << allocations << " allocations, "
+            << (receptions == 0 ? 0 : (double)allocations / receptions) << " per reception" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Measure the WifiRemoteStationManager of a road-side unit which sees
+// transient peers: they come into range one after the other, exchange
+// frames for a while and leave for good. Every second, each peer in range
+// exchanges a few data frames, each of which looks up its remote station
+// for the RTS decision, the tx vector, the ack and a reception.
+//
+//   ./bench-station-manager --peers=5000 --dwell=30 --idleTimeout=10
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+static Ptr<WifiRemoteStationManager> g_manager;
+static std::vector<Mac48Address> g_peers;
+static double g_arrivalRate;
+static double g_dwell;
+static uint32_t g_frames;
+static uint32_t g_peakStations = 0;
+static uint64_t g_lookups = 0;
+
+static void
+Step (void)
+{
+  Ptr<const Packet> packet = Create<Packet> (200);
+  WifiMode mode = WifiMode ("OfdmRate6Mbps");
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  double now = Simulator::Now ().GetSeconds ();
+  uint32_t first = now > g_dwell ? (now - g_dwell) * g_arrivalRate : 0;
+  uint32_t last = std::min<uint32_t> (now * g_arrivalRate + 1, g_peers.size ());
+  for (uint32_t i = first; i < last; i++)
+    {
+      hdr.SetAddr1 (g_peers[i]);
+      for (uint32_t j = 0; j < g_frames; j++)
+        {
+          g_manager->NeedRts (g_peers[i], &hdr, packet);
+          g_manager->GetDataTxVector (g_peers[i], &hdr, packet, packet->GetSize () + 36);
+          g_manager->ReportDataOk (g_peers[i], &hdr, 20, mode, 20);
+          g_manager->ReportRxOk (g_peers[i], &hdr, 20, mode);
+          g_lookups += 4;
+        }
+    }
+  g_peakStations = std::max (g_peakStations, g_manager->GetNRemoteStations ());
+  if (first < g_peers.size ())
+    {
+      Simulator::Schedule (Seconds (1), &Step);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t peers = 5000;
+  double idleTimeout = 10;
+  std::string manager = "ns3::ArfWifiManager";
+  g_arrivalRate = 10;
+  g_dwell = 30;
+  g_frames = 2;
+
+  CommandLine cmd;
+  cmd.AddValue ("peers", "Number of peers which come and go.", peers);
+  cmd.AddValue ("arrivalRate", "Number of peers coming into range per second.", g_arrivalRate);
+  cmd.AddValue ("dwell", "Seconds each peer stays in range.", g_dwell);
+  cmd.AddValue ("frames", "Data frames exchanged with each peer in range per second.", g_frames);
+  cmd.AddValue ("idleTimeout", "StationIdleTimeout in seconds, zero to keep every peer.", idleTimeout);
+  cmd.AddValue ("manager", "TypeId of the remote station manager.", manager);
+  cmd.Parse (argc, argv);
+
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  ObjectFactory factory;
+  factory.SetTypeId (manager);
+  factory.Set ("StationIdleTimeout", TimeValue (Seconds (idleTimeout)));
+  g_manager = factory.Create<WifiRemoteStationManager> ();
+  g_manager->SetupPhy (phy);
+  for (uint32_t i = 0; i < peers; i++)
+    {
+      g_peers.push_back (Mac48Address::Allocate ());
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Schedule (Seconds (0), &Step);
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  uint32_t stations = g_manager->GetNRemoteStations ();
+  std::cout << g_lookups << " lookups in " << elapsed << "ms ("
+            << (g_lookups == 0 ? 0 : 1e6 * elapsed / g_lookups) << "ns each)" << std::endl
+            << "remote stations: " << g_peakStations << " at most, " << stations << " at the end, about "
+            << stations * sizeof (WifiRemoteStationState) / 1024 << "KiB of states" << std::endl;
+  Simulator::Destroy ();
+  g_manager->Dispose ();
+  g_manager = 0;
+  return 0;
+}
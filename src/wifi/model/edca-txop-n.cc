@@ -390,16 +390,11 @@ EdcaTxopN::NotifyAccessGranted (void)
             }
         }
     }
-  MacLowTransmissionParameters params;
-  params.DisableOverrideDurationId ();
   if (m_currentHdr.GetAddr1 ().IsGroup ())
     {
-      params.DisableRts ();
-      params.DisableAck ();
-      params.DisableNextData ();
       StartTransmission (m_currentPacket,
                          &m_currentHdr,
-                         params,
+                         GetTransmissionParameters (m_currentPacket, m_currentHdr, 0),
                          m_transmissionListener);
 
       NS_LOG_DEBUG ("tx broadcast");
@@ -408,102 +403,163 @@ EdcaTxopN::NotifyAccessGranted (void)
     {
       SendBlockAckRequest (m_currentBar);
     }
+  else if (IsFragmented (m_currentPacket, m_currentHdr))
+    {
+      MacLowTransmissionParameters params = GetTransmissionParameters (m_currentPacket, m_currentHdr,
+                                                                       m_fragmentNumber);
+      WifiMacHeader hdr;
+      Ptr<Packet> fragment = GetFragmentPacket (&hdr);
+      if (IsLastFragment ())
+        {
+          NS_LOG_DEBUG ("fragmenting last fragment size=" << fragment->GetSize ());
+        }
+      else
+        {
+          NS_LOG_DEBUG ("fragmenting size=" << fragment->GetSize ());
+        }
+      StartTransmission (fragment, &hdr, params,
+                         m_transmissionListener);
+    }
   else
     {
-      if (m_currentHdr.IsQosData () && m_currentHdr.IsQosBlockAck ())
+      m_currentPacket = AggregateMsdus (m_currentPacket, &m_currentHdr, true);
+      if (m_currentHdr.IsQosAmsdu ())
+        {
+          NS_LOG_DEBUG ("tx unicast A-MSDU");
+        }
+      MacLowTransmissionParameters params = GetTransmissionParameters (m_currentPacket, m_currentHdr, 0);
+      if (params.MustSendRts ())
         {
-          params.DisableAck ();
+          NS_LOG_DEBUG ("tx unicast rts");
         }
       else
         {
-          params.EnableAck ();
+          NS_LOG_DEBUG ("tx unicast");
         }
-      if (NeedFragmentation () && ((m_currentHdr.IsQosData ()
-                                    && !m_currentHdr.IsQosAmsdu ())
-                                   ||
-                                   (m_currentHdr.IsData ()
-                                    && !m_currentHdr.IsQosData () && m_currentHdr.IsQosAmsdu ()))
-          && (m_blockAckThreshold == 0
-              || m_blockAckType == BASIC_BLOCK_ACK))
+      StartTransmission (m_currentPacket, &m_currentHdr,
+                         params, m_transmissionListener);
+      CompleteTx ();
+    }
+}
+
+Ptr<const Packet>
+EdcaTxopN::AggregateMsdus (Ptr<const Packet> packet, WifiMacHeader *hdr, bool dequeue)
+{
+  NS_LOG_FUNCTION (this << packet << hdr << dequeue);
+  if (m_aggregator == 0 || !hdr->IsQosData () || hdr->GetAddr1 ().IsBroadcast () || hdr->IsRetry ())
+    {
+      return packet;
+    }
+  uint8_t tid = hdr->GetQosTid ();
+  Mac48Address to = hdr->GetAddr1 ();
+  // the n-th MSDU to the same receiver in the queue, which is packet
+  // itself when it was not dequeued
+  uint32_t n = 0;
+  WifiMacHeader peekedHdr;
+  Ptr<const Packet> peekedPacket = m_queue->PeekNthByTidAndAddress (&peekedHdr, tid, to, n);
+  if (peekedPacket == packet)
+    {
+      peekedPacket = m_queue->PeekNthByTidAndAddress (&peekedHdr, tid, to, ++n);
+    }
+  if (peekedPacket == 0)
+    {
+      return packet;
+    }
+  /* here is performed aggregation */
+  Ptr<Packet> currentAggregatedPacket = Create<Packet> ();
+  m_aggregator->Aggregate (packet, currentAggregatedPacket,
+                           MapSrcAddressForAggregation (peekedHdr),
+                           MapDestAddressForAggregation (peekedHdr));
+  bool isAmsdu = false;
+  while (peekedPacket != 0)
+    {
+      if (!m_aggregator->Aggregate (peekedPacket, currentAggregatedPacket,
+                                    MapSrcAddressForAggregation (peekedHdr),
+                                    MapDestAddressForAggregation (peekedHdr)))
         {
-          //With COMPRESSED_BLOCK_ACK fragmentation must be avoided.
-          params.DisableRts ();
-          WifiMacHeader hdr;
-          Ptr<Packet> fragment = GetFragmentPacket (&hdr);
-          if (IsLastFragment ())
-            {
-              NS_LOG_DEBUG ("fragmenting last fragment size=" << fragment->GetSize ());
-              params.DisableNextData ();
-            }
-          else
-            {
-              NS_LOG_DEBUG ("fragmenting size=" << fragment->GetSize ());
-              params.EnableNextData (GetNextFragmentSize ());
-            }
-          StartTransmission (fragment, &hdr, params,
-                             m_transmissionListener);
+          break;
+        }
+      isAmsdu = true;
+      if (dequeue)
+        {
+          m_queue->Remove (peekedPacket);
         }
       else
         {
-          WifiMacHeader peekedHdr;
-          if (m_currentHdr.IsQosData ()
-              && m_queue->PeekByTidAndAddress (&peekedHdr, m_currentHdr.GetQosTid (),
-                                               WifiMacHeader::ADDR1, m_currentHdr.GetAddr1 ())
-              && !m_currentHdr.GetAddr1 ().IsBroadcast ()
-              && m_aggregator != 0 && !m_currentHdr.IsRetry ())
-            {
-              /* here is performed aggregation */
-              Ptr<Packet> currentAggregatedPacket = Create<Packet> ();
-              m_aggregator->Aggregate (m_currentPacket, currentAggregatedPacket,
-                                       MapSrcAddressForAggregation (peekedHdr),
-                                       MapDestAddressForAggregation (peekedHdr));
-              bool aggregated = false;
-              bool isAmsdu = false;
-              Ptr<const Packet> peekedPacket = m_queue->PeekByTidAndAddress (&peekedHdr, m_currentHdr.GetQosTid (),
-                                                                             WifiMacHeader::ADDR1,
-                                                                             m_currentHdr.GetAddr1 ());
-              while (peekedPacket != 0)
-                {
-                  aggregated = m_aggregator->Aggregate (peekedPacket, currentAggregatedPacket,
-                                                        MapSrcAddressForAggregation (peekedHdr),
-                                                        MapDestAddressForAggregation (peekedHdr));
-                  if (aggregated)
-                    {
-                      isAmsdu = true;
-                      m_queue->Remove (peekedPacket);
-                    }
-                  else
-                    {
-                      break;
-                    }
-                  peekedPacket = m_queue->PeekByTidAndAddress (&peekedHdr, m_currentHdr.GetQosTid (),
-                                                               WifiMacHeader::ADDR1, m_currentHdr.GetAddr1 ());
-                }
-              if (isAmsdu)
-                {
-                  m_currentHdr.SetQosAmsdu ();
-                  m_currentHdr.SetAddr3 (m_low->GetBssid ());
-                  m_currentPacket = currentAggregatedPacket;
-                  currentAggregatedPacket = 0;
-                  NS_LOG_DEBUG ("tx unicast A-MSDU");
-                }
-            }
-          if (NeedRts ())
-            {
-              params.EnableRts ();
-              NS_LOG_DEBUG ("tx unicast rts");
-            }
-          else
-            {
-              params.DisableRts ();
-              NS_LOG_DEBUG ("tx unicast");
-            }
+          n++;
+        }
+      peekedPacket = m_queue->PeekNthByTidAndAddress (&peekedHdr, tid, to, n);
+      if (peekedPacket == packet)
+        {
+          peekedPacket = m_queue->PeekNthByTidAndAddress (&peekedHdr, tid, to, ++n);
+        }
+    }
+  if (!isAmsdu)
+    {
+      return packet;
+    }
+  hdr->SetQosAmsdu ();
+  hdr->SetAddr3 (m_low->GetBssid ());
+  return currentAggregatedPacket;
+}
+
+bool
+EdcaTxopN::IsFragmented (Ptr<const Packet> packet, const WifiMacHeader &hdr) const
+{
+  //With COMPRESSED_BLOCK_ACK fragmentation must be avoided.
+  return m_stationManager->NeedFragmentation (hdr.GetAddr1 (), &hdr, packet)
+         && ((hdr.IsQosData () && !hdr.IsQosAmsdu ())
+             || (hdr.IsData () && !hdr.IsQosData () && hdr.IsQosAmsdu ()))
+         && (m_blockAckThreshold == 0 || m_blockAckType == BASIC_BLOCK_ACK);
+}
+
+MacLowTransmissionParameters
+EdcaTxopN::GetTransmissionParameters (Ptr<const Packet> packet, const WifiMacHeader &hdr,
+                                      uint32_t fragmentNumber) const
+{
+  MacLowTransmissionParameters params;
+  params.DisableOverrideDurationId ();
+  if (hdr.GetAddr1 ().IsGroup ())
+    {
+      params.DisableRts ();
+      params.DisableAck ();
+      params.DisableNextData ();
+      return params;
+    }
+  if (hdr.IsQosData () && hdr.IsQosBlockAck ())
+    {
+      params.DisableAck ();
+    }
+  else
+    {
+      params.EnableAck ();
+    }
+  if (IsFragmented (packet, hdr))
+    {
+      params.DisableRts ();
+      if (m_stationManager->IsLastFragment (hdr.GetAddr1 (), &hdr, packet, fragmentNumber))
+        {
           params.DisableNextData ();
-          StartTransmission (m_currentPacket, &m_currentHdr,
-                             params, m_transmissionListener);
-          CompleteTx ();
         }
+      else
+        {
+          params.EnableNextData (m_stationManager->GetFragmentSize (hdr.GetAddr1 (), &hdr, packet,
+                                                                    fragmentNumber + 1));
+        }
+    }
+  else
+    {
+      if (m_stationManager->NeedRts (hdr.GetAddr1 (), &hdr, packet))
+        {
+          params.EnableRts ();
+        }
+      else
+        {
+          params.DisableRts ();
+        }
+      params.DisableNextData ();
     }
+  return params;
 }
 
 void EdcaTxopN::NotifyInternalCollision (void)
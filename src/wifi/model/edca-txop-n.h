@@ -112,7 +112,7 @@ public:
 
   /* dcf notifications forwarded here */
   bool NeedsAccess (void) const;
-  void NotifyAccessGranted (void);
+  virtual void NotifyAccessGranted (void);
   void NotifyInternalCollision (void);
   void NotifyCollision (void);
   /**
@@ -177,6 +177,29 @@ protected:
                                   const WifiMacHeader* hdr,
                                   MacLowTransmissionParameters params,
                                   MacLowTransmissionListener *listener);
+  /**
+   * \param packet the MSDU to send, no longer or still in the queue
+   * \param hdr the header of the MSDU, set to the header of the A-MSDU if any
+   * \param dequeue whether the MSDUs aggregated are removed from the queue
+   * \returns the A-MSDU of packet and of the following MSDUs of the queue
+   * with the same receiver and TID, or packet if none can be aggregated
+   */
+  Ptr<const Packet> AggregateMsdus (Ptr<const Packet> packet, WifiMacHeader *hdr, bool dequeue);
+  /**
+   * \param packet the MSDU or the A-MSDU to send
+   * \param hdr the header of the packet
+   * \returns true if the packet is sent in fragments
+   */
+  bool IsFragmented (Ptr<const Packet> packet, const WifiMacHeader &hdr) const;
+  /**
+   * \param packet the MSDU or the A-MSDU to send
+   * \param hdr the header of the packet
+   * \param fragmentNumber the fragment to send, if the packet is fragmented
+   * \returns the parameters with which NotifyAccessGranted sends the packet,
+   * or its fragment, unless it is a block ack request
+   */
+  MacLowTransmissionParameters GetTransmissionParameters (Ptr<const Packet> packet, const WifiMacHeader &hdr,
+                                                          uint32_t fragmentNumber) const;
   Ptr<WifiMacQueue> m_queue;
   /* current packet could be a simple MSDU or, if an aggregator for this queue is
      present, could be an A-MSDU.
@@ -55,4 +55,16 @@ ErrorRateModel::CalculateSnr (WifiMode txMode, double ber) const
   return low;
 }
 
+double
+ErrorRateModel::GetChunksSuccessRate (WifiMode mode, const double *snr, const uint32_t *nbits,
+                                      uint32_t n) const
+{
+  double psr = 1.0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      psr *= GetChunkSuccessRate (mode, snr[i], nbits[i]);
+    }
+  return psr;
+}
+
 } // namespace ns3
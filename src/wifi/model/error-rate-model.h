@@ -44,6 +44,18 @@ public:
   double CalculateSnr (WifiMode txMode, double ber) const;
 
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const = 0;
+  /**
+   * \param mode the transmission mode of the chunks
+   * \param snr the snr of each chunk
+   * \param nbits the number of bits of each chunk
+   * \param n the number of chunks
+   * \returns the probability that all the chunks are received without
+   *          error.
+   *
+   * The default implementation multiplies the success rates of the chunks.
+   */
+  virtual double GetChunksSuccessRate (WifiMode mode, const double *snr, const uint32_t *nbits,
+                                       uint32_t n) const;
 };
 
 } // namespace ns3
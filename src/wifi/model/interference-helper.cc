@@ -124,7 +124,9 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_past (0),
+    m_pastPower (0.0)
 {
 }
 InterferenceHelper::~InterferenceHelper ()
@@ -179,17 +181,13 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
+  SkipPastChanges ();
+  double noiseInterferenceW = m_pastPower;
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (NiChanges::const_iterator i = m_niChanges.begin () + m_past; i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
       if (noiseInterferenceW < energyW)
         {
           break;
@@ -204,13 +202,18 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   Time now = Simulator::Now ();
   if (!m_rxing)
     {
+      // the changes up to now are folded into m_firstPower
+      SkipPastChanges ();
+      m_firstPower = m_pastPower;
       NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
+      for (NiChanges::iterator i = m_niChanges.begin () + m_past; i != nowIterator; i++)
         {
           m_firstPower += i->GetDelta ();
         }
       m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      m_past = 0;
+      m_pastPower = m_firstPower;
+      m_niChanges.push_front (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
   else
     {
@@ -236,41 +239,56 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const
 {
-  double noiseInterference = m_firstPower;
-  NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  if (duration == NanoSeconds (0))
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
+      return 1.0;
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
-  return noiseInterference;
+  uint32_t rate = mode.GetPhyRate ();
+  uint64_t nbits = (uint64_t)(rate * duration.GetSeconds ());
+  double csr = m_errorRateModel->GetChunkSuccessRate (mode, snir, (uint32_t)nbits);
+  return csr;
 }
 
-double
-InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const
+void
+InterferenceHelper::AddPayloadChunk (double snir, Time duration, WifiMode mode) const
 {
   if (duration == NanoSeconds (0))
     {
-      return 1.0;
+      return;
     }
   uint32_t rate = mode.GetPhyRate ();
   uint64_t nbits = (uint64_t)(rate * duration.GetSeconds ());
-  double csr = m_errorRateModel->GetChunkSuccessRate (mode, snir, (uint32_t)nbits);
-  return csr;
+  m_payloadSnir.push_back (snir);
+  m_payloadBits.push_back ((uint32_t)nbits);
+}
+
+double
+InterferenceHelper::CalculatePayloadSuccessRate (WifiMode mode) const
+{
+  if (m_payloadSnir.empty ())
+    {
+      return 1.0;
+    }
+  double psr = m_errorRateModel->GetChunksSuccessRate (mode, &m_payloadSnir[0], &m_payloadBits[0],
+                                                       m_payloadSnir.size ());
+  m_payloadSnir.clear ();
+  m_payloadBits.clear ();
+  return psr;
 }
 
 double
-InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event) const
 {
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
+  NS_ASSERT (m_rxing);
+  // the first change is the start of the signal being received, and the
+  // changes from its end on do not interfere with it.
+  NiChanges::const_iterator j = m_niChanges.begin ();
+  NiChanges::const_iterator last = std::lower_bound (m_niChanges.begin (), m_niChanges.end (),
+                                                     NiChange (event->GetEndTime (), 0));
+  NS_ASSERT ((*j).GetTime () == event->GetStartTime ());
   Time previous = (*j).GetTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
@@ -285,21 +303,21 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
   Time plcpHsigHeaderStart=plcpHeaderStart+ MicroSeconds (WifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble));//packet start time+ preamble+L SIG
   Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + MicroSeconds (WifiPhy::GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble));//packet start time+ preamble+L SIG+HT SIG
   Time plcpPayloadStart =plcpHtTrainingSymbolsStart + MicroSeconds (WifiPhy::GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble,event->GetTxVector())); //packet start time+ preamble+L SIG+HT SIG+Training
-  double noiseInterferenceW = (*j).GetDelta ();
+  double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
     j++;
-  while (ni->end () != j)
+  while (true)
     {
-      Time current = (*j).GetTime ();
+      Time current = j == last ? event->GetEndTime () : (*j).GetTime ();
       NS_ASSERT (current >= previous);
       //Case 1: Both prev and curr point to the payload
       if (previous >= plcpPayloadStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          payloadMode),
-                                            current - previous,
-                                            payloadMode);
+          AddPayloadChunk (CalculateSnr (powerW,
+                                         noiseInterferenceW,
+                                         payloadMode),
+                           current - previous,
+                           payloadMode);
         }
       //Case 2: previous is before payload
       else if (previous >= plcpHtTrainingSymbolsStart)
@@ -308,11 +326,11 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
           if (current >= plcpPayloadStart)
             { 
                //Case 2ai and 2aii: All formats
-               psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                current - plcpPayloadStart,
-                                                payloadMode);
+               AddPayloadChunk (CalculateSnr (powerW,
+                                             noiseInterferenceW,
+                                             payloadMode),
+                               current - plcpPayloadStart,
+                               payloadMode);
                 
               }
         }
@@ -322,11 +340,11 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
           //Case 3a: cuurent after payload start
           if (current >=plcpPayloadStart)
              {
-                   psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                current - plcpPayloadStart,
-                                                payloadMode);
+                   AddPayloadChunk (CalculateSnr (powerW,
+                                             noiseInterferenceW,
+                                             payloadMode),
+                               current - plcpPayloadStart,
+                               payloadMode);
                  
                     psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
                                                               noiseInterferenceW,
@@ -361,11 +379,11 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
           //Case 4a: current after payload start  
           if (current >=plcpPayloadStart)
              {
-                   psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                      current - plcpPayloadStart,
-                                                      payloadMode);
+                   AddPayloadChunk (CalculateSnr (powerW,
+                                             noiseInterferenceW,
+                                             payloadMode),
+                                     current - plcpPayloadStart,
+                                     payloadMode);
                     //Case 4ai: Non HT format (No HT-SIG or Training Symbols)
               if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT) //plcpHtTrainingSymbolsStart==plcpHeaderStart)
                 {
@@ -446,11 +464,11 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
           if (current >= plcpPayloadStart)
             {
               //for all
-              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                              noiseInterferenceW,
-                                                              payloadMode),
-                                                current - plcpPayloadStart,
-                                                payloadMode); 
+              AddPayloadChunk (CalculateSnr (powerW,
+                                             noiseInterferenceW,
+                                             payloadMode),
+                               current - plcpPayloadStart,
+                               payloadMode); 
              
                // Non HT format (No HT-SIG or Training Symbols)
               if (preamble == WIFI_PREAMBLE_LONG || preamble == WIFI_PREAMBLE_SHORT)
@@ -528,10 +546,15 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
             }
         }
 
+      if (j == last)
+        {
+          break;
+        }
       noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
+      previous = current;
       j++;
     }
+  psr *= CalculatePayloadSuccessRate (payloadMode);
 
   double per = 1 - psr;
   return per;
@@ -541,16 +564,16 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NS_ASSERT (m_rxing);
+  double noiseInterferenceW = m_firstPower;
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
 
-  /* calculate the SNIR at the start of the packet and accumulate
-   * all SNIR changes in the snir vector.
+  /* calculate the SNIR at the start of the packet and walk the SNIR
+   * changes until its end.
    */
-  double per = CalculatePer (event, &ni);
+  double per = CalculatePer (event);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -564,6 +587,18 @@ InterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
+  m_past = 0;
+  m_pastPower = 0.0;
+}
+void
+InterferenceHelper::SkipPastChanges (void)
+{
+  Time now = Simulator::Now ();
+  while (m_past < m_niChanges.size () && m_niChanges[m_past].GetTime () < now)
+    {
+      m_pastPower += m_niChanges[m_past].GetDelta ();
+      m_past++;
+    }
 }
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::GetPosition (Time moment)
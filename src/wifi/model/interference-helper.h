@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <deque>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -111,16 +112,36 @@ private:
     Time m_time;
     double m_delta;
   };
-  typedef std::vector <NiChange> NiChanges;
+  /**
+   * The changes of the noise and interference power, sorted by time.
+   * The changes up to the start of the signal being received, or up to
+   * the last signal added when none is received, are folded into
+   * m_firstPower, so only those of the signals still on the medium are
+   * kept.
+   */
+  typedef std::deque<NiChange> NiChanges;
   typedef std::list<Ptr<Event> > Events;
 
   InterferenceHelper (const InterferenceHelper &o);
   InterferenceHelper &operator = (const InterferenceHelper &o);
   void AppendEvent (Ptr<Event> event);
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
   double CalculateSnr (double signal, double noiseInterference, WifiMode mode) const;
   double CalculateChunkSuccessRate (double snir, Time delay, WifiMode mode) const;
-  double CalculatePer (Ptr<const Event> event, NiChanges *ni) const;
+  /**
+   * Add a chunk of the payload to the batch evaluated by
+   * CalculatePayloadSuccessRate.
+   */
+  void AddPayloadChunk (double snir, Time duration, WifiMode mode) const;
+  /**
+   * \returns the probability that the chunks added by AddPayloadChunk are
+   * all received without error, and clears them.
+   */
+  double CalculatePayloadSuccessRate (WifiMode mode) const;
+  /**
+   * \returns the packet error rate of the signal being received, walking
+   * the changes of m_niChanges from its start to its end.
+   */
+  double CalculatePer (Ptr<const Event> event) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -128,8 +149,19 @@ private:
   NiChanges m_niChanges;
   double m_firstPower;
   bool m_rxing;
+  // the number of changes of m_niChanges before now, and the power after them
+  uint32_t m_past;
+  double m_pastPower;
+  // the payload chunks of the event of CalculatePer
+  mutable std::vector<double> m_payloadSnir;
+  mutable std::vector<uint32_t> m_payloadBits;
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
+  /**
+   * Add the changes before now to m_pastPower. The changes are only
+   * inserted from now on, so each change is skipped once.
+   */
+  void SkipPastChanges (void);
   void AddNiChangeEvent (NiChange change);
 };
 
@@ -650,7 +650,7 @@ MacLow::NotifySwitchingStartNow (Time duration)
 }
 
 void
-MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamble preamble)
+MacLow::ReceiveOk (Ptr<const Packet> packet, double rxSnr, WifiMode txMode, WifiPreamble preamble)
 {
   NS_LOG_FUNCTION (this << packet << rxSnr << txMode << preamble);
   /* A packet is received from the PHY.
@@ -659,7 +659,7 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
    * packet queue.
    */
   WifiMacHeader hdr;
-  packet->RemoveHeader (hdr);
+  packet->PeekHeader (hdr);
 
   bool isPrevNavZero = IsNavZero ();
   NS_LOG_DEBUG ("duration/id=" << hdr.GetDuration ());
@@ -698,7 +698,7 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
     {
       NS_LOG_DEBUG ("receive cts from=" << m_currentHdr.GetAddr1 ());
       SnrTag tag;
-      packet->RemovePacketTag (tag);
+      packet->PeekPacketTag (tag);
       m_stationManager->ReportRxOk (m_currentHdr.GetAddr1 (), &m_currentHdr,
                                     rxSnr, txMode);
       m_stationManager->ReportRtsOk (m_currentHdr.GetAddr1 (), &m_currentHdr,
@@ -723,7 +723,7 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
     {
       NS_LOG_DEBUG ("receive ack from=" << m_currentHdr.GetAddr1 ());
       SnrTag tag;
-      packet->RemovePacketTag (tag);
+      packet->PeekPacketTag (tag);
       m_stationManager->ReportRxOk (m_currentHdr.GetAddr1 (), &m_currentHdr,
                                     rxSnr, txMode);
       m_stationManager->ReportDataOk (m_currentHdr.GetAddr1 (), &m_currentHdr,
@@ -759,14 +759,14 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
     {
       NS_LOG_DEBUG ("got block ack from " << hdr.GetAddr2 ());
       CtrlBAckResponseHeader blockAck;
-      packet->RemoveHeader (blockAck);
+      CopyPayload (packet, hdr)->RemoveHeader (blockAck);
       m_blockAckTimeoutEvent.Cancel ();
       m_listener->GotBlockAck (&blockAck, hdr.GetAddr2 ());
     }
   else if (hdr.IsBlockAckReq () && hdr.GetAddr1 () == m_self)
     {
       CtrlBAckRequestHeader blockAckReq;
-      packet->RemoveHeader (blockAckReq);
+      CopyPayload (packet, hdr)->RemoveHeader (blockAckReq);
       if (!blockAckReq.IsMultiTid ())
         {
           uint8_t tid = blockAckReq.GetTidInfo ();
@@ -901,12 +901,20 @@ MacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamb
     }
   return;
 rxPacket:
-  WifiMacTrailer fcs;
-  packet->RemoveTrailer (fcs);
-  m_rxCallback (packet, &hdr);
+  m_rxCallback (CopyPayload (packet, hdr), &hdr);
   return;
 }
 
+Ptr<Packet>
+MacLow::CopyPayload (Ptr<const Packet> packet, const WifiMacHeader &hdr) const
+{
+  // a fragment shares the buffer of the packet, like a copy, and its
+  // header and trailer are dropped without being deserialized again.
+  WifiMacTrailer fcs;
+  uint32_t start = hdr.GetSerializedSize ();
+  return packet->CreateFragment (start, packet->GetSize () - start - fcs.GetSerializedSize ());
+}
+
 uint32_t
 MacLow::GetAckSize (void) const
 {
@@ -1746,14 +1754,12 @@ MacLow::SendAckAfterData (Mac48Address source, Time duration, WifiMode dataTxMod
 }
 
 bool
-MacLow::StoreMpduIfNeeded (Ptr<Packet> packet, WifiMacHeader hdr)
+MacLow::StoreMpduIfNeeded (Ptr<const Packet> packet, WifiMacHeader hdr)
 {
   AgreementsI it = m_bAckAgreements.find (std::make_pair (hdr.GetAddr2 (), hdr.GetQosTid ()));
   if (it != m_bAckAgreements.end ())
     {
-      WifiMacTrailer fcs;
-      packet->RemoveTrailer (fcs);
-      BufferedPacket bufferedPacket (packet, hdr);
+      BufferedPacket bufferedPacket (CopyPayload (packet, hdr), hdr);
 
       uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
       uint16_t mappedSeqControl = QosUtilsMapSeqControlToUniqueInteger (hdr.GetSequenceControl (), endSequence);
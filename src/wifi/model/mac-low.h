@@ -459,9 +459,11 @@ public:
    * \param preamble type of preamble used for the packet received
    *
    * This method is typically invoked by the lower PHY layer to notify
-   * the MAC layer that a packet was successfully received.
+   * the MAC layer that a packet was successfully received. The packet
+   * is shared with the other receivers of the same transmission: it is
+   * only copied when its MAC header must be removed.
    */
-  void ReceiveOk (Ptr<Packet> packet, double rxSnr, WifiMode txMode, WifiPreamble preamble);
+  void ReceiveOk (Ptr<const Packet> packet, double rxSnr, WifiMode txMode, WifiPreamble preamble);
   /**
    * \param packet packet received.
    * \param rxSnr snr of packet received.
@@ -602,7 +604,15 @@ private:
    * in order of increasing sequence control field. All comparison are performed
    * circularly modulo 2^12.
    */
-  bool StoreMpduIfNeeded (Ptr<Packet> packet, WifiMacHeader hdr);
+  bool StoreMpduIfNeeded (Ptr<const Packet> packet, WifiMacHeader hdr);
+  /**
+   * \param packet a packet received from the PHY, including its MAC header
+   * and its FCS.
+   * \param hdr the MAC header of the packet
+   * \return a copy of the packet without its MAC header and its FCS,
+   * which can be modified.
+   */
+  Ptr<Packet> CopyPayload (Ptr<const Packet> packet, const WifiMacHeader &hdr) const;
   /*
    * Invoked after that a block ack request has been received. Looks for corresponding
    * block ack agreement and creates block ack bitmap on a received packets basis.
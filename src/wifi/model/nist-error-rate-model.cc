@@ -22,6 +22,11 @@
 #include "nist-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/core-config.h"
+#ifdef NS3_MULTITHREADED
+#include "ns3/system-mutex.h"
+#endif
 
 NS_LOG_COMPONENT_DEFINE ("NistErrorRateModel");
 
@@ -35,6 +40,12 @@ NistErrorRateModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::NistErrorRateModel")
     .SetParent<ErrorRateModel> ()
     .AddConstructor<NistErrorRateModel> ()
+    .AddAttribute ("UseTables",
+                   "Whether the chunk success rates of the OFDM modes are interpolated "
+                   "in tables of the coded bit error rates, rather than calculated for each chunk.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&NistErrorRateModel::m_useTables),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -189,8 +200,207 @@ NistErrorRateModel::GetFec64QamBer (double snr, uint32_t nbits,
   double pms = std::pow (1 - pe, static_cast<double> (nbits));
   return pms;
 }
+double
+NistErrorRateModel::GetFecBer (uint32_t constellationSize, uint32_t bValue, double snr) const
+{
+  double ber = 0.0;
+  switch (constellationSize)
+    {
+    case 2:
+      ber = GetBpskBer (snr);
+      break;
+    case 4:
+      ber = GetQpskBer (snr);
+      break;
+    case 16:
+      ber = Get16QamBer (snr);
+      break;
+    case 64:
+      ber = Get64QamBer (snr);
+      break;
+    default:
+      NS_ASSERT (false);
+    }
+  if (ber == 0.0)
+    {
+      return 0.0;
+    }
+  return std::min (CalculatePe (ber, bValue), 1.0);
+}
+
+const NistErrorRateModel::SuccessTable *
+NistErrorRateModel::GetSuccessTable (uint32_t constellationSize, uint32_t bValue) const
+{
+  static SuccessTable tables[4][3];
+#ifdef NS3_MULTITHREADED
+  static SystemMutex mutex;
+  CriticalSection cs (mutex);
+#endif
+  // the scale of the SNR in the argument of erfc
+  double scale;
+  uint32_t i;
+  switch (constellationSize)
+    {
+    case 2:
+      scale = 1.0;
+      i = 0;
+      break;
+    case 4:
+      scale = 2.0;
+      i = 1;
+      break;
+    case 16:
+      scale = 10.0;
+      i = 2;
+      break;
+    default:
+      NS_ASSERT (constellationSize == 64);
+      scale = 42.0;
+      i = 3;
+      break;
+    }
+  NS_ASSERT (bValue >= 1 && bValue <= 3);
+  SuccessTable *table = &tables[i][bValue - 1];
+  if (!table->samples.empty ())
+    {
+      return table;
+    }
+  // With this step, the cubic interpolation of the samples is within 1e-9
+  // of the logarithm, at worst at the lowest SNRs, so the relative error of
+  // a success rate exp (-nbits * loss) stays below 1e-6 down to exp (-1000),
+  // which underflows anyway. The tables end when the coded bit error rate
+  // falls below 1e-20, from where 1 - pe rounds to 1.
+  table->step = 0.005 * scale;
+  uint32_t k = 0;
+  while (GetFecBer (constellationSize, bValue, k * table->step) >= 1e-2)
+    {
+      k++;
+    }
+  table->first = k + 1;
+  while (true)
+    {
+      double pe = GetFecBer (constellationSize, bValue, k * table->step);
+      table->samples.push_back (std::log (-log1p (-pe)));
+      if (pe < 1e-20 && table->samples.size () > 3)
+        {
+          break;
+        }
+      k++;
+    }
+  table->last = k - 1;
+  NS_LOG_DEBUG ("table of constellation " << constellationSize << " b " << bValue
+                << " from snr " << table->first * table->step
+                << " to " << table->last * table->step
+                << ", " << table->samples.size () << " samples");
+  return table;
+}
+
+const NistErrorRateModel::SuccessTable *
+NistErrorRateModel::GetSuccessTable (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid >= m_modeTables.size ())
+    {
+      ModeTable unknown = { false, 0 };
+      m_modeTables.resize (uid + 1, unknown);
+    }
+  ModeTable *entry = &m_modeTables[uid];
+  if (entry->known)
+    {
+      return entry->table;
+    }
+  entry->known = true;
+  entry->table = 0;
+  if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
+      || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
+      || mode.GetModulationClass () == WIFI_MOD_CLASS_HT)
+    {
+      uint32_t constellationSize = mode.GetConstellationSize ();
+      if (constellationSize == 2 || constellationSize == 4 || constellationSize == 16)
+        {
+          entry->table = GetSuccessTable (constellationSize,
+                                          mode.GetCodeRate () == WIFI_CODE_RATE_1_2 ? 1 : 3);
+        }
+      else if (constellationSize == 64)
+        {
+          entry->table = GetSuccessTable (constellationSize,
+                                          mode.GetCodeRate () == WIFI_CODE_RATE_2_3 ? 2 : 3);
+        }
+    }
+  return entry->table;
+}
+
+/**
+ * \param y the samples -1, 0, 1 and 2 of a table
+ * \param x the position between the samples 0 and 1, from 0 to 1
+ * \returns the value at x of the cubic polynomial through the samples
+ */
+static double
+Interpolate (const double *y, double x)
+{
+  double xp1 = x + 1.0;
+  double xm1 = x - 1.0;
+  double xm2 = x - 2.0;
+  return (xp1 * x * (xm1 * y[3] - 3.0 * xm2 * y[2])
+          + xm1 * xm2 * (3.0 * xp1 * y[1] - x * y[0])) / 6.0;
+}
+
 double
 NistErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  const SuccessTable *table = m_useTables ? GetSuccessTable (mode) : 0;
+  if (table == 0)
+    {
+      return CalculateChunkSuccessRate (mode, snr, nbits);
+    }
+  double x = snr / table->step;
+  if (x >= table->last)
+    {
+      return 1.0;
+    }
+  if (x < table->first)
+    {
+      return CalculateChunkSuccessRate (mode, snr, nbits);
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double loss = std::exp (Interpolate (&table->samples[i - table->first], x - i));
+  return std::exp (-loss * nbits);
+}
+
+double
+NistErrorRateModel::GetChunksSuccessRate (WifiMode mode, const double *snr, const uint32_t *nbits,
+                                          uint32_t n) const
+{
+  const SuccessTable *table = m_useTables ? GetSuccessTable (mode) : 0;
+  if (table == 0)
+    {
+      return ErrorRateModel::GetChunksSuccessRate (mode, snr, nbits, n);
+    }
+  // the success rates of the interpolated chunks are multiplied by adding
+  // up their exponents, so that a single exp is left for the whole batch.
+  double psr = 1.0;
+  double loss = 0.0;
+  const double *samples = &table->samples[0];
+  for (uint32_t j = 0; j < n; j++)
+    {
+      double x = snr[j] / table->step;
+      if (x >= table->last)
+        {
+          continue;
+        }
+      if (x < table->first)
+        {
+          psr *= CalculateChunkSuccessRate (mode, snr[j], nbits[j]);
+          continue;
+        }
+      uint32_t i = static_cast<uint32_t> (x);
+      loss += std::exp (Interpolate (samples + (i - table->first), x - i)) * nbits[j];
+    }
+  return psr * std::exp (-loss);
+}
+
+double
+NistErrorRateModel::CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM|| mode.GetModulationClass()==WIFI_MOD_CLASS_HT)
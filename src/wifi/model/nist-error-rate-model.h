@@ -21,6 +21,7 @@
 #define NIST_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <vector>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 #include "dsss-error-rate-model.h"
@@ -34,6 +35,14 @@ namespace ns3 {
  * the model description and validation can be found in
  * http://www.nsnam.org/~pei/80211ofdm.pdf.  For DSSS modulations (802.11b),
  * the model uses the DsssErrorRateModel.
+ *
+ * When the UseTables attribute is true, the OFDM chunk success rates are
+ * not calculated for each chunk: the coded bit error rate of each
+ * constellation and code rate is sampled once, at regular SNR steps, the
+ * first time a mode which uses them is evaluated, and it is interpolated
+ * between the samples. The interpolated success rates are within a relative
+ * error of 1e-6 of the calculated ones. The low SNRs, for which the coded
+ * bit error rate exceeds 1e-2, are always calculated.
  */
 class NistErrorRateModel : public ErrorRateModel
 {
@@ -43,8 +52,41 @@ public:
   NistErrorRateModel ();
 
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+  virtual double GetChunksSuccessRate (WifiMode mode, const double *snr, const uint32_t *nbits,
+                                       uint32_t n) const;
 
 private:
+  /**
+   * The logarithm of -log (1 - pe), pe being the coded bit error rate of a
+   * constellation and a code rate, sampled every step of SNR. The samples
+   * of the intervals [first, last) and of their two neighbours are kept,
+   * the SNRs above the last interval are received without error.
+   */
+  struct SuccessTable
+  {
+    double step;
+    uint32_t first;
+    uint32_t last;
+    std::vector<double> samples;
+  };
+  struct ModeTable
+  {
+    bool known;
+    const SuccessTable *table;
+  };
+
+  /**
+   * \returns the table of the constellation and code rate of the mode, or
+   * zero if the mode is not interpolated.
+   */
+  const SuccessTable * GetSuccessTable (WifiMode mode) const;
+  const SuccessTable * GetSuccessTable (uint32_t constellationSize, uint32_t bValue) const;
+  /**
+   * \returns the coded bit error rate, or zero if the uncoded bit error
+   * rate is zero.
+   */
+  double GetFecBer (uint32_t constellationSize, uint32_t bValue, double snr) const;
+  double CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
   double CalculatePe (double p, uint32_t bValue) const;
   double GetBpskBer (double snr) const;
   double GetQpskBer (double snr) const;
@@ -58,6 +100,10 @@ private:
                          uint32_t bValue) const;
   double GetFec64QamBer (double snr, uint32_t nbits,
                          uint32_t bValue) const;
+
+  bool m_useTables;
+  // the table of each mode, by uid
+  mutable std::vector<ModeTable> m_modeTables;
 };
 
 
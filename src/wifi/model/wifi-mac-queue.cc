@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include <algorithm>
 
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
@@ -59,7 +60,8 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : m_size (0)
+  : m_fifo (m_queue.end ()),
+    m_size (0)
 {
 }
 
@@ -101,33 +103,86 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       return;
     }
   Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
+  PacketQueueI it = m_queue.insert (m_queue.end (), Item (packet, hdr, now));
+  if (m_fifo == m_queue.end ())
+    {
+      m_fifo = it;
+    }
+  if (hdr.IsQosData ())
+    {
+      GetIndex (hdr.GetQosTid (), hdr.GetAddr1 ()).push_back (it);
+    }
   m_size++;
 }
 
 void
 WifiMacQueue::Cleanup (void)
 {
-  if (m_queue.empty ())
+  Time now = Simulator::Now ();
+  // the items moved to the front keep their time stamp, so the few items
+  // at the front are not in the order of their time stamps
+  PacketQueueI it = m_queue.begin ();
+  while (it != m_fifo)
     {
-      return;
+      if (it->tstamp + m_maxDelay <= now)
+        {
+          it = Erase (it);
+        }
+      else
+        {
+          it++;
+        }
+    }
+  while (m_fifo != m_queue.end () && m_fifo->tstamp + m_maxDelay <= now)
+    {
+      Erase (m_fifo);
     }
+}
 
-  Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end ();)
+WifiMacQueue::PacketQueueI
+WifiMacQueue::Erase (PacketQueueI it)
+{
+  if (it == m_fifo)
     {
-      if (i->tstamp + m_maxDelay > now)
+      m_fifo++;
+    }
+  if (it->hdr.IsQosData ())
+    {
+      QosIndexI i = m_index.find (std::make_pair (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()));
+      NS_ASSERT (i != m_index.end ());
+      std::deque<PacketQueueI> &index = i->second;
+      if (index.front () == it)
         {
-          i++;
+          index.pop_front ();
         }
       else
         {
-          i = m_queue.erase (i);
-          n++;
+          index.erase (std::find (index.begin (), index.end (), it));
+        }
+      if (index.empty ())
+        {
+          m_index.erase (i);
         }
     }
-  m_size -= n;
+  m_size--;
+  return m_queue.erase (it);
+}
+
+std::deque<WifiMacQueue::PacketQueueI> &
+WifiMacQueue::GetIndex (uint8_t tid, Mac48Address addr)
+{
+  return m_index[std::make_pair (addr, tid)];
+}
+
+std::deque<WifiMacQueue::PacketQueueI> *
+WifiMacQueue::FindIndex (uint8_t tid, Mac48Address addr)
+{
+  QosIndexI i = m_index.find (std::make_pair (addr, tid));
+  if (i == m_index.end ())
+    {
+      return 0;
+    }
+  return &i->second;
 }
 
 Ptr<const Packet>
@@ -136,11 +191,10 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
-      *hdr = i.hdr;
-      return i.packet;
+      Ptr<const Packet> packet = m_queue.front ().packet;
+      *hdr = m_queue.front ().hdr;
+      Erase (m_queue.begin ());
+      return packet;
     }
   return 0;
 }
@@ -151,9 +205,8 @@ WifiMacQueue::Peek (WifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      Item i = m_queue.front ();
-      *hdr = i.hdr;
-      return i.packet;
+      *hdr = m_queue.front ().hdr;
+      return m_queue.front ().packet;
     }
   return 0;
 }
@@ -164,6 +217,18 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
+  if (type == WifiMacHeader::ADDR1)
+    {
+      std::deque<PacketQueueI> *index = FindIndex (tid, dest);
+      if (index != 0)
+        {
+          PacketQueueI it = index->front ();
+          packet = it->packet;
+          *hdr = it->hdr;
+          Erase (it);
+        }
+      return packet;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -177,8 +242,7 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
+                  Erase (it);
                   break;
                 }
             }
@@ -192,6 +256,16 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      std::deque<PacketQueueI> *index = FindIndex (tid, dest);
+      if (index != 0)
+        {
+          *hdr = index->front ()->hdr;
+          return index->front ()->packet;
+        }
+      return 0;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -212,6 +286,20 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
   return 0;
 }
 
+Ptr<const Packet>
+WifiMacQueue::PeekNthByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
+                                      Mac48Address addr, uint32_t n)
+{
+  Cleanup ();
+  std::deque<PacketQueueI> *index = FindIndex (tid, addr);
+  if (index == 0 || n >= index->size ())
+    {
+      return 0;
+    }
+  *hdr = (*index)[n]->hdr;
+  return (*index)[n]->packet;
+}
+
 bool
 WifiMacQueue::IsEmpty (void)
 {
@@ -230,6 +318,8 @@ void
 WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_fifo = m_queue.end ();
+  m_index.clear ();
   m_size = 0;
 }
 
@@ -259,8 +349,34 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+WifiMacQueue::MoveToFront (Callback<bool, Ptr<const Packet>, const WifiMacHeader *> match)
+{
+  Cleanup ();
+  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+    {
+      if (match (it->packet, &it->hdr))
+        {
+          if (it != m_queue.begin ())
+            {
+              // unlike PushFront, keep the time stamp, so that the packet
+              // still expires MaxDelay after it was queued
+              Item item = *it;
+              Erase (it);
+              m_queue.push_front (item);
+              if (item.hdr.IsQosData ())
+                {
+                  GetIndex (item.hdr.GetQosTid (), item.hdr.GetAddr1 ()).push_front (m_queue.begin ());
+                }
+              m_size++;
+            }
           return true;
         }
     }
@@ -277,6 +393,10 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     }
   Time now = Simulator::Now ();
   m_queue.push_front (Item (packet, hdr, now));
+  if (hdr.IsQosData ())
+    {
+      GetIndex (hdr.GetQosTid (), hdr.GetAddr1 ()).push_front (m_queue.begin ());
+    }
   m_size++;
 }
 
@@ -285,6 +405,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
                                           Mac48Address addr)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      std::deque<PacketQueueI> *index = FindIndex (tid, addr);
+      return index == 0 ? 0 : index->size ();
+    }
   uint32_t nPackets = 0;
   if (!m_queue.empty ())
     {
@@ -318,8 +443,7 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return packet;
         }
     }
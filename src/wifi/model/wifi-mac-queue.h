@@ -23,10 +23,13 @@
 #define WIFI_MAC_QUEUE_H
 
 #include <list>
+#include <deque>
+#include <map>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
+#include "ns3/callback.h"
 #include "wifi-mac-header.h"
 
 namespace ns3 {
@@ -46,6 +49,13 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * The packets enqueued at the back expire in their order in the queue,
+ * and the packets pushed at the front expire in the reverse order, so
+ * the expired packets are always found next to the boundary between
+ * them and the check costs nothing for the packets which have not
+ * expired. The QoS data packets are also indexed by their address1 and
+ * TID, for the lookups by TID and address1.
  */
 class WifiMacQueue : public Object
 {
@@ -68,7 +78,7 @@ public:
    * address indicated by <i>type</i> equals to <i>addr</i>, and tid
    * equals to <i>tid</i>. This method removes the packet from this queue.
    * Is typically used by ns3::EdcaTxopN in order to perform correct MSDU
-   * aggregation (A-MSDU).
+   * aggregation (A-MSDU). The lookup by address1 does not search the queue.
    */
   Ptr<const Packet> DequeueByTidAndAddress (WifiMacHeader *hdr,
                                             uint8_t tid,
@@ -79,18 +89,37 @@ public:
    * address indicated by <i>type</i> equals to <i>addr</i>, and tid
    * equals to <i>tid</i>. This method doesn't remove the packet from this queue.
    * Is typically used by ns3::EdcaTxopN in order to perform correct MSDU
-   * aggregation (A-MSDU).
+   * aggregation (A-MSDU). The lookup by address1 does not search the queue.
    */
   Ptr<const Packet> PeekByTidAndAddress (WifiMacHeader *hdr,
                                          uint8_t tid,
                                          WifiMacHeader::AddressType type,
                                          Mac48Address addr);
+  /**
+   * Returns the <i>n</i>-th packet of this queue, counting from 0, having
+   * address1 equals to <i>addr</i> and tid equals to <i>tid</i>, or 0 if
+   * there are no more than <i>n</i> such packets. This method doesn't
+   * remove the packet from this queue. Is used by ns3::EdcaTxopN to know
+   * the A-MSDU it would send without removing its packets.
+   */
+  Ptr<const Packet> PeekNthByTidAndAddress (WifiMacHeader *hdr,
+                                            uint8_t tid,
+                                            Mac48Address addr,
+                                            uint32_t n);
   /**
    * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
    * takes no effects and return false. Deletion of the packet is
    * performed in linear time (O(n)).
    */
   bool Remove (Ptr<const Packet> packet);
+  /**
+   * Moves the first packet of this queue for which <i>match</i> returns true
+   * to the front of the queue, with the time stamp it was queued with, and
+   * returns true. Returns false if <i>match</i> returns false for every
+   * packet. The packets are tried in the order in which they would be
+   * dequeued.
+   */
+  bool MoveToFront (Callback<bool, Ptr<const Packet>, const WifiMacHeader *> match);
   /**
    * Returns number of QoS packets having tid equals to <i>tid</i> and address
    * specified by <i>type</i> equals to <i>addr</i>.
@@ -128,6 +157,27 @@ protected:
   typedef std::list<struct Item>::iterator PacketQueueI;
 
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI);
+  /**
+   * Remove an item from m_queue, m_fifo and m_index.
+   *
+   * \param it the item to remove
+   * \returns the item following it
+   */
+  PacketQueueI Erase (PacketQueueI it);
+  /**
+   * \param tid the TID of the QoS data packets
+   * \param addr the address1 of the QoS data packets
+   * \returns the items of these packets in m_queue, in their order in m_queue,
+   * created empty if no such packet is queued
+   */
+  std::deque<PacketQueueI> &GetIndex (uint8_t tid, Mac48Address addr);
+  /**
+   * \param tid the TID of the QoS data packets
+   * \param addr the address1 of the QoS data packets
+   * \returns the items of these packets in m_queue, or 0 if no such packet
+   * is queued
+   */
+  std::deque<PacketQueueI> *FindIndex (uint8_t tid, Mac48Address addr);
 
   struct Item
   {
@@ -139,7 +189,15 @@ protected:
     Time tstamp;
   };
 
+  // the entries are erased when their last packet leaves the queue
+  typedef std::map<std::pair<Mac48Address, uint8_t>, std::deque<PacketQueueI> > QosIndex;
+  typedef std::map<std::pair<Mac48Address, uint8_t>, std::deque<PacketQueueI> >::iterator QosIndexI;
+
   PacketQueue m_queue;
+  // the first item enqueued at the back, after the items pushed or moved
+  // to the front
+  PacketQueueI m_fifo;
+  QosIndex m_index;
   uint32_t m_size;
   uint32_t m_maxSize;
   Time m_maxDelay;
@@ -93,6 +93,23 @@ WifiPhy::~WifiPhy ()
   NS_LOG_FUNCTION (this);
 }
 
+/**
+ * Hand a copy of a packet received successfully to a callback which may
+ * modify it.
+ */
+static void
+CopyReceivedPacket (Callback<void,Ptr<Packet>, double, WifiMode, enum WifiPreamble> callback,
+                    Ptr<const Packet> packet, double snr, WifiMode mode, enum WifiPreamble preamble)
+{
+  callback (packet->Copy (), snr, mode, preamble);
+}
+
+void
+WifiPhy::SetReceiveOkCallback (Callback<void,Ptr<Packet>, double, WifiMode, enum WifiPreamble> callback)
+{
+  SetReceiveOkCallback (MakeBoundCallback (&CopyReceivedPacket, callback));
+}
+
 //Added by Ghada to support 11n
 
 //return the L-SIG
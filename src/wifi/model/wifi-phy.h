@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include "ns3/callback.h"
+#include "ns3/deprecated.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
@@ -145,12 +146,16 @@ public:
   };
 
   /**
-   * arg1: packet received successfully
+   * arg1: packet received successfully, shared with the other
+   *       receivers of the same transmission
    * arg2: snr of packet
    * arg3: mode of packet
    * arg4: type of preamble used for packet.
+   *
+   * The packet used to be a private Ptr<Packet>: see the deprecated
+   * SetReceiveOkCallback overload for the callbacks which modify it.
    */
-  typedef Callback<void,Ptr<Packet>, double, WifiMode, enum WifiPreamble> RxOkCallback;
+  typedef Callback<void,Ptr<const Packet>, double, WifiMode, enum WifiPreamble> RxOkCallback;
   /**
    * arg1: packet received unsuccessfully
    * arg2: snr of packet
@@ -174,6 +179,15 @@ public:
    *        upon successful packet reception.
    */
   virtual void SetReceiveOkCallback (RxOkCallback callback) = 0;
+  /**
+   * \param callback the callback to invoke upon successful packet
+   *        reception, with a copy of the packet which it may modify.
+   *
+   * \deprecated The callback of this overload costs a copy of every
+   * packet received successfully: take a Ptr<const Packet> and copy the
+   * packet only where it is modified, as MacLow does.
+   */
+  void SetReceiveOkCallback (Callback<void,Ptr<Packet>, double, WifiMode, enum WifiPreamble> callback) NS_DEPRECATED;
   /**
    * \param callback the callback to invoke
    *        upon erroneous packet reception.
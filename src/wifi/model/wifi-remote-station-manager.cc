@@ -288,6 +288,12 @@ WifiRemoteStationManager::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&WifiRemoteStationManager::m_defaultTxPowerLevel),
                    MakeUintegerChecker<uint8_t> ())
+    .AddAttribute ("StationIdleTimeout", "The time after which the state of a remote station which is not "
+                   "associated and has not been looked up is deleted, to free the memory of the peers which "
+                   "went away. The state is deleted within twice this time. Zero keeps the states forever.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WifiRemoteStationManager::m_stationIdleTimeout),
+                   MakeTimeChecker ())
     .AddTraceSource ("MacTxRtsFailed",
                      "The transmission of a RTS by the MAC layer has failed",
                      MakeTraceSourceAccessor (&WifiRemoteStationManager::m_macTxRtsFailed))
@@ -305,6 +311,7 @@ WifiRemoteStationManager::GetTypeId (void)
 }
 
 WifiRemoteStationManager::WifiRemoteStationManager ()
+  : m_nStates (0)
 {
 }
 
@@ -316,14 +323,13 @@ WifiRemoteStationManager::DoDispose (void)
 {
   for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
-      delete (*i);
+      if (*i != 0)
+        {
+          DeleteState (*i);
+        }
     }
   m_states.clear ();
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
-    {
-      delete (*i);
-    }
-  m_stations.clear ();
+  m_nStates = 0;
 }
 void
 WifiRemoteStationManager::SetupPhy (Ptr<WifiPhy> phy)
@@ -1122,16 +1128,122 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
   return state->m_info;
 }
 
+uint32_t
+WifiRemoteStationManager::GetNRemoteStations (void) const
+{
+  return m_nStates;
+}
+
+/**
+ * \param address a MAC address
+ * \returns the hash of the address, well spread over the 32 bits
+ */
+static uint32_t
+HashStationAddress (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return (key * 0x9e3779b97f4a7c15ULL) >> 32;
+}
+
+uint32_t
+WifiRemoteStationManager::FindState (Mac48Address address) const
+{
+  uint32_t mask = m_states.size () - 1;
+  uint32_t i = HashStationAddress (address) & mask;
+  while (m_states[i] != 0 && m_states[i]->m_address != address)
+    {
+      i = (i + 1) & mask;
+    }
+  return i;
+}
+
+void
+WifiRemoteStationManager::ResizeStates (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT ((size & (size - 1)) == 0 && 2 * m_nStates <= size);
+  StationStates states (size, static_cast<WifiRemoteStationState *> (0));
+  m_states.swap (states);
+  for (StationStates::const_iterator i = states.begin (); i != states.end (); i++)
+    {
+      if (*i != 0)
+        {
+          m_states[FindState ((*i)->m_address)] = *i;
+        }
+    }
+}
+
+void
+WifiRemoteStationManager::DeleteIdleStates (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time now = Simulator::Now ();
+  for (StationStates::iterator i = m_states.begin (); i != m_states.end (); i++)
+    {
+      WifiRemoteStationState *state = *i;
+      if (state != 0
+          && state->m_state != WifiRemoteStationState::WAIT_ASSOC_TX_OK
+          && state->m_state != WifiRemoteStationState::GOT_ASSOC_TX_OK
+          && now - state->m_lastUsed >= m_stationIdleTimeout)
+        {
+          NS_LOG_DEBUG ("delete idle remote station " << state->m_address);
+          DeleteState (state);
+          *i = 0;
+          m_nStates--;
+        }
+    }
+  // the deleted entries break the probe sequences, so the table is
+  // rebuilt, at a smaller size if it is mostly empty.
+  uint32_t size = m_states.size ();
+  while (size > 64 && 8 * m_nStates < size)
+    {
+      size /= 2;
+    }
+  ResizeStates (size);
+}
+
+void
+WifiRemoteStationManager::DeleteState (WifiRemoteStationState *state)
+{
+  for (std::vector<WifiRemoteStation *>::const_iterator i = state->m_stations.begin ();
+       i != state->m_stations.end (); i++)
+    {
+      delete (*i);
+    }
+  delete state;
+}
+
 WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  WifiRemoteStationManager *self = const_cast<WifiRemoteStationManager *> (this);
+  if (m_nStates != 0)
     {
-      if ((*i)->m_address == address)
+      WifiRemoteStationState *state = m_states[FindState (address)];
+      if (state != 0)
         {
-          return (*i);
+          state->m_lastUsed = Simulator::Now ();
+          return state;
+        }
+    }
+  if (m_stationIdleTimeout.IsStrictlyPositive () && Simulator::Now () >= m_nextIdleCheck)
+    {
+      self->m_nextIdleCheck = Simulator::Now () + m_stationIdleTimeout;
+      if (m_nStates != 0)
+        {
+          self->DeleteIdleStates ();
         }
     }
+  if (2 * (m_nStates + 1) > m_states.size ())
+    {
+      self->ResizeStates (m_states.empty () ? 64 : 2 * m_states.size ());
+    }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
   state->m_address = address;
@@ -1142,7 +1254,9 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_rx=1;
   state->m_tx=1;
   state->m_stbc=false;
-  const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  state->m_lastUsed = Simulator::Now ();
+  self->m_states[FindState (address)] = state;
+  self->m_nStates++;
   return state;
 }
 WifiRemoteStation *
@@ -1162,23 +1276,22 @@ WifiRemoteStationManager::Lookup (Mac48Address address, const WifiMacHeader *hea
 WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  WifiRemoteStationState *state = LookupState (address);
+  for (std::vector<WifiRemoteStation *>::const_iterator i = state->m_stations.begin ();
+       i != state->m_stations.end (); i++)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
+      if ((*i)->m_tid == tid)
         {
           return (*i);
         }
     }
-  WifiRemoteStationState *state = LookupState (address);
 
   WifiRemoteStation *station = DoCreateStation ();
   station->m_state = state;
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
-  // XXX
-  const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  state->m_stations.push_back (station);
   return station;
 
 }
@@ -1211,11 +1324,19 @@ WifiRemoteStationManager::GetDefaultMcs (void) const
 void
 WifiRemoteStationManager::Reset (void)
 {
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
-      delete (*i);
+      if (*i == 0)
+        {
+          continue;
+        }
+      for (std::vector<WifiRemoteStation *>::const_iterator j = (*i)->m_stations.begin ();
+           j != (*i)->m_stations.end (); j++)
+        {
+          delete (*j);
+        }
+      (*i)->m_stations.clear ();
     }
-  m_stations.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicRateSet.push_back (m_defaultTxMode);
   m_bssBasicMcsSet.clear();
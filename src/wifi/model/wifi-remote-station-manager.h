@@ -78,6 +78,16 @@ private:
  * \ingroup wifi
  * \brief hold a list of per-remote-station state.
  *
+ * The states of the remote stations are kept in an open-addressing hash
+ * table keyed by their address, and each state holds the stations of its
+ * TIDs, so a lookup takes a constant time however many peers were seen.
+ *
+ * When the StationIdleTimeout attribute is positive, the states of the
+ * remote stations which are not associated and were not looked up for
+ * that long are deleted, together with their stations, when a new remote
+ * station is added. A remote station looked up again afterwards starts
+ * over as a brand new one.
+ *
  * \sa ns3::WifiRemoteStation.
  */
 class WifiRemoteStationManager : public Object
@@ -329,6 +339,10 @@ public:
    * \returns information regarding the remote station associated with the given address
    */
   WifiRemoteStationInfo GetInfo (Mac48Address address);
+  /**
+   * \returns the number of remote stations whose state is kept
+   */
+  uint32_t GetNRemoteStations (void) const;
   /**
    * Set the default transmission power level
    */
@@ -486,6 +500,24 @@ private:
                              double rxSnr, WifiMode txMode) = 0;
 
   WifiRemoteStationState* LookupState (Mac48Address address) const;
+  /**
+   * \param address the address of a remote station
+   * \returns the index in m_states of the state of address, or of the free
+   * entry where it would be inserted.
+   */
+  uint32_t FindState (Mac48Address address) const;
+  /**
+   * \param size the new size of m_states, a power of two
+   *
+   * Reinsert the states of m_states in a table of the given size.
+   */
+  void ResizeStates (uint32_t size);
+  /**
+   * Delete the states which are not associated and were not looked up
+   * for StationIdleTimeout, and shrink m_states if it gets sparse.
+   */
+  void DeleteIdleStates (void);
+  void DeleteState (WifiRemoteStationState *state);
   WifiRemoteStation* Lookup (Mac48Address address, uint8_t tid) const;
   /// Find a remote station by its remote address and TID taken from MAC header
   WifiRemoteStation* Lookup (Mac48Address address, const WifiMacHeader *header) const;
@@ -495,11 +527,13 @@ private:
   uint32_t DoGetFragmentationThreshold (void) const;
   uint32_t GetNFragments (const WifiMacHeader *header, Ptr<const Packet> packet);
 
-  typedef std::vector <WifiRemoteStation *> Stations;
   typedef std::vector <WifiRemoteStationState *> StationStates;
 
+  // the hash table of the states, zero for its free entries
   StationStates m_states;
-  Stations m_stations;
+  uint32_t m_nStates;
+  Time m_stationIdleTimeout;
+  Time m_nextIdleCheck;
   /**
    * This is a pointer to the WifiPhy associated with this
    * WifiRemoteStationManager that is set on call to
@@ -582,6 +616,10 @@ struct WifiRemoteStationState
   bool m_stbc;
   bool m_greenfield;
 
+  /// the stations of this remote station, one per TID looked up
+  std::vector<WifiRemoteStation *> m_stations;
+  /// the last time this remote station was looked up
+  Time m_lastUsed;
 };
 
 /**
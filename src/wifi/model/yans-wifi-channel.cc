@@ -20,15 +20,22 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/wifi-phy.h"
+#include <algorithm>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
 
@@ -50,11 +57,36 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange", "The distance (m) beyond which a transmission is not delivered to a PHY, "
+                   "and the cell size of the grid used to find the PHYs in range. Zero delivers "
+                   "every transmission to all the PHYs of the channel. With random propagation "
+                   "loss models, a positive range changes the results, as fewer values are drawn.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("CacheLinks", "Reuse the rx power and the delay calculated between two PHYs "
+                   "until one of them moves. Only valid with propagation models without randomness. "
+                   "The cache holds an entry of 32 bytes for every pair of a sender and a PHY of the "
+                   "channel, up to MaxCachedLinks entries.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_cacheLinks),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxCachedLinks", "The number of links beyond which the cache of CacheLinks is emptied "
+                   "before a new sender is added to it, e.g. 32 MB for the default value.",
+                   UintegerValue (1000000),
+                   MakeUintegerAccessor (&YansWifiChannel::m_maxCachedLinks),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0.0),
+    m_cacheLinks (false),
+    m_maxCachedLinks (1000000),
+    m_partitionsValid (false),
+    m_tracked (0),
+    m_nCachedLinks (0)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
@@ -63,64 +95,424 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  FlushLinks ();
+  std::vector<std::vector<Link> > ().swap (m_links);
+  WifiChannel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (Ptr<PropagationLossModel> loss)
 {
   m_loss = loss;
+  FlushLinks ();
 }
 void
 YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
 {
   m_delay = delay;
+  FlushLinks ();
+}
+
+void
+YansWifiChannel::FlushLinks (void) const
+{
+  for (std::vector<std::vector<Link> >::iterator i = m_links.begin (); i != m_links.end (); i++)
+    {
+      // give the memory of the row back, which clear does not
+      std::vector<Link> ().swap (*i);
+    }
+  m_nCachedLinks = 0;
 }
 
 void
 YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
                        WifiTxVector txVector, WifiPreamble preamble) const
 {
+#ifdef NS3_MULTITHREADED
+  CriticalSection cs (m_mutex);
+#endif
+  UpdatePartitions ();
+#ifdef NS3_MULTITHREADED
+  UpdateMovedCells ();
+#endif
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  uint32_t senderSystemId = 0;
+  if (sender->GetDevice () != 0)
     {
-      if (sender != (*i))
+      senderSystemId = sender->GetDevice ()->GetObject<NetDevice> ()->GetNode ()->GetSystemId ();
+    }
+  if (m_partitions.size () > 1)
+    {
+      // the other system ids calculate the propagation on their own
+      // partition, from the position of the sender now.
+      Ptr<MobilityModel> snapshot = CreateObject<ConstantPositionMobilityModel> ();
+      snapshot->SetPosition (senderMobility->GetPosition ());
+      Ptr<Transmission> tx = Create<Transmission> ();
+      tx->sender = snapshot;
+      tx->channelNumber = sender->GetChannelNumber ();
+      tx->txPowerDbm = txPowerDbm;
+      tx->txVector = txVector;
+      tx->preamble = preamble;
+      for (Partitions::const_iterator i = m_partitions.begin (); i != m_partitions.end (); i++)
         {
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (i->first != senderSystemId)
             {
-              continue;
+#ifdef NS3_MULTITHREADED
+              // the receivers may run in another thread while the sender
+              // still holds the packet: give them their own packet, which
+              // shares the buffers
+              Ptr<const Packet> copy = packet->Copy ();
+#else
+              Ptr<const Packet> copy = packet;
+#endif
+              Simulator::ScheduleWithContext (i->second.context, m_lookAhead,
+                                              &YansWifiChannel::ReceiveForwarded, this,
+                                              i->first, Ptr<const Transmission> (tx), copy);
             }
+        }
+    }
+  Partitions::iterator local = m_partitions.find (senderSystemId);
+  NS_ASSERT (local != m_partitions.end ());
+  uint32_t senderIndex = 0;
+  if (m_cacheLinks)
+    {
+      TrackCourseChanges ();
+      PhyIndex::const_iterator index = m_phyIndex.find (PeekPointer (sender));
+      NS_ASSERT_MSG (index != m_phyIndex.end (), "the sender was not added to this channel");
+      senderIndex = index->second;
+      if (m_links.size () < m_phyList.size ())
+        {
+          m_links.resize (m_phyList.size ());
+        }
+    }
+  if (m_maxRange > 0)
+    {
+      std::vector<uint32_t> receivers = GetReceiversInRange (local->second, senderMobility->GetPosition ());
+      for (std::vector<uint32_t>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
+        {
+          Ptr<YansWifiPhy> receiver = m_phyList[*i];
+          if (sender != receiver
+              && receiver->GetChannelNumber () == sender->GetChannelNumber ()
+              && senderMobility->GetDistanceFrom (receiver->GetMobility ()->GetObject<MobilityModel> ()) <= m_maxRange)
+            {
+              SendTo (senderIndex, *i, senderMobility, packet, txPowerDbm, txVector, preamble);
+            }
+        }
+      return;
+    }
+  // For now don't account for inter channel interference
+  ChannelReceivers::const_iterator receivers = local->second.receivers.find (sender->GetChannelNumber ());
+  NS_ASSERT (receivers != local->second.receivers.end ());
+  for (std::vector<uint32_t>::const_iterator i = receivers->second.begin (); i != receivers->second.end (); i++)
+    {
+      if (sender != m_phyList[*i])
+        {
+          SendTo (senderIndex, *i, senderMobility, packet, txPowerDbm, txVector, preamble);
+        }
+    }
+}
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+void
+YansWifiChannel::SendTo (uint32_t i, uint32_t j, Ptr<MobilityModel> senderMobility,
+                         Ptr<const Packet> packet, double txPowerDbm, WifiTxVector txVector,
+                         WifiPreamble preamble) const
+{
+  Time delay;
+  double rxPowerDbm;
+  Link *link = 0;
+  if (m_cacheLinks)
+    {
+      std::vector<Link> &links = m_links[i];
+      if (links.size () <= j)
+        {
+          uint32_t added = m_phyList.size () - links.size ();
+          if (m_nCachedLinks + added > m_maxCachedLinks)
+            {
+              NS_LOG_DEBUG ("flush " << m_nCachedLinks << " cached links");
+              FlushLinks ();
+              added = m_phyList.size ();
+            }
+          if (added <= m_maxCachedLinks)
             {
-              dstNode = 0xffffffff;
+              Link invalid;
+              invalid.senderMoves = 0;
+              invalid.receiverMoves = 0;
+              invalid.txPowerDbm = 0;
+              invalid.rxPowerDbm = 0;
+              links.resize (m_phyList.size (), invalid);
+              m_nCachedLinks += added;
             }
-          else
+        }
+      if (j < links.size ())
+        {
+          link = &links[j];
+        }
+    }
+  if (link != 0
+      && link->senderMoves == m_moves[i]
+      && link->receiverMoves == m_moves[j]
+      && link->txPowerDbm == txPowerDbm)
+    {
+      delay = link->delay;
+      rxPowerDbm = link->rxPowerDbm;
+    }
+  else
+    {
+      Ptr<MobilityModel> receiverMobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      // the CourseChange trace is not invoked as a node moves along its
+      // course, so the links of the moving nodes are not cached.
+      if (link != 0
+          && CalculateDistance (senderMobility->GetVelocity (), Vector ()) == 0
+          && CalculateDistance (receiverMobility->GetVelocity (), Vector ()) == 0)
+        {
+          link->senderMoves = m_moves[i];
+          link->receiverMoves = m_moves[j];
+          link->txPowerDbm = txPowerDbm;
+          link->rxPowerDbm = rxPowerDbm;
+          link->delay = delay;
+        }
+    }
+  Ptr<Node> node = GetNode (j);
+  uint32_t dstNode = node == 0 ? 0xffffffff : node->GetId ();
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive, this,
+                                  j, packet, rxPowerDbm, txVector, preamble);
+}
+
+Ptr<Node>
+YansWifiChannel::GetNode (uint32_t i) const
+{
+  Ptr<Object> device = m_phyList[i]->GetDevice ();
+  if (device == 0)
+    {
+      return 0;
+    }
+  return device->GetObject<NetDevice> ()->GetNode ();
+}
+
+void
+YansWifiChannel::UpdatePartitions (void) const
+{
+  if (m_partitionsValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  // the devices of the PHYs may be set after the PHYs are added, so the
+  // system ids are only looked up once the simulation runs.
+  m_partitions.clear ();
+  m_systemIds.resize (m_phyList.size ());
+  m_cells.resize (m_phyList.size ());
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<Node> node = GetNode (i);
+      m_systemIds[i] = node == 0 ? 0 : node->GetSystemId ();
+      std::pair<Partitions::iterator, bool> added = m_partitions.insert (std::make_pair (m_systemIds[i], Partition ()));
+      Partition &partition = added.first->second;
+      if (added.second)
+        {
+          partition.context = node == 0 ? 0xffffffff : node->GetId ();
+          partition.maxSpeed = 0.0;
+          partition.gridValid = false;
+        }
+      partition.phys.push_back (i);
+      partition.receivers[m_phyList[i]->GetChannelNumber ()].push_back (i);
+    }
+  m_lookAhead = m_partitions.size () > 1 ? GetLookAhead () : Seconds (0);
+  m_partitionsValid = true;
+}
+
+std::vector<uint32_t>
+YansWifiChannel::GetReceiversInRange (Partition &partition, const Vector &position) const
+{
+  double elapsed = (Simulator::Now () - partition.gridTime).GetSeconds ();
+  if (!partition.gridValid || partition.maxSpeed * elapsed > m_maxRange / 2)
+    {
+      BuildGrid (partition);
+      elapsed = 0;
+    }
+  // a PHY may have moved away from the cell it is recorded in by at
+  // most maxSpeed * elapsed since the grid was built.
+  double range = m_maxRange + partition.maxSpeed * elapsed;
+  Cell low = GetCell (Vector (position.x - range, position.y - range, 0));
+  Cell high = GetCell (Vector (position.x + range, position.y + range, 0));
+  std::vector<uint32_t> receivers;
+  for (int32_t x = low.first; x <= high.first; x++)
+    {
+      for (int32_t y = low.second; y <= high.second; y++)
+        {
+          Grid::const_iterator cell = partition.grid.find (Cell (x, y));
+          if (cell != partition.grid.end ())
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              receivers.insert (receivers.end (), cell->second.begin (), cell->second.end ());
             }
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, txVector, preamble);
         }
     }
+  // keep the order of m_phyList, so the receptions in range are scheduled
+  // in the same order as without grid.
+  std::sort (receivers.begin (), receivers.end ());
+  return receivers;
+}
+
+YansWifiChannel::Cell
+YansWifiChannel::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int32_t> (std::floor (position.x / m_maxRange)),
+               static_cast<int32_t> (std::floor (position.y / m_maxRange)));
+}
+
+void
+YansWifiChannel::BuildGrid (Partition &partition) const
+{
+  NS_LOG_FUNCTION (this);
+  partition.grid.clear ();
+  partition.maxSpeed = 0;
+  TrackCourseChanges ();
+  for (std::vector<uint32_t>::const_iterator i = partition.phys.begin (); i != partition.phys.end (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[*i]->GetMobility ()->GetObject<MobilityModel> ();
+      m_cells[*i] = GetCell (mobility->GetPosition ());
+      partition.grid[m_cells[*i]].push_back (*i);
+      partition.maxSpeed = std::max (partition.maxSpeed, CalculateDistance (mobility->GetVelocity (), Vector ()));
+    }
+  partition.gridTime = Simulator::Now ();
+  partition.gridValid = true;
+}
+
+void
+YansWifiChannel::TrackCourseChanges (void) const
+{
+  for (uint32_t i = m_tracked; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&YansWifiChannel::CourseChanged, this).Bind (i));
+    }
+  m_tracked = m_phyList.size ();
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+YansWifiChannel::CourseChanged (uint32_t i, Ptr<const MobilityModel> mobility) const
+{
+  double speed = CalculateDistance (mobility->GetVelocity (), Vector ());
+#ifdef NS3_MULTITHREADED
+  // the course changes in the thread of the partition of the PHY, which
+  // may be within Send while m_mutex is held: record the position, and
+  // let the next Send move the PHY to its new cell.
+  Move move;
+  move.phy = i;
+  move.position = mobility->GetPosition ();
+  move.speed = speed;
+  CriticalSection cs (m_movedMutex);
+  m_moves[i]++;
+  m_moved.push_back (move);
+#else
+  m_moves[i]++;
+  MoveToCell (i, mobility->GetPosition (), speed);
+#endif
+}
+
+void
+YansWifiChannel::MoveToCell (uint32_t i, const Vector &position, double speed) const
+{
+  if (!m_partitionsValid)
+    {
+      return;
+    }
+  Partition &partition = m_partitions[m_systemIds[i]];
+  if (!partition.gridValid)
+    {
+      return;
+    }
+  Cell cell = GetCell (position);
+  if (cell != m_cells[i])
+    {
+      std::vector<uint32_t> &phys = partition.grid[m_cells[i]];
+      phys.erase (std::find (phys.begin (), phys.end (), i));
+      partition.grid[cell].push_back (i);
+      m_cells[i] = cell;
+    }
+  partition.maxSpeed = std::max (partition.maxSpeed, speed);
+}
+
+#ifdef NS3_MULTITHREADED
+void
+YansWifiChannel::UpdateMovedCells (void) const
+{
+  std::vector<Move> moved;
+  {
+    CriticalSection cs (m_movedMutex);
+    moved.swap (m_moved);
+  }
+  for (std::vector<Move>::const_iterator i = moved.begin (); i != moved.end (); i++)
+    {
+      MoveToCell (i->phy, i->position, i->speed);
+    }
+}
+#endif
+
+void
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                           WifiTxVector txVector, WifiPreamble preamble) const
 {
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txVector, preamble);
 }
 
+void
+YansWifiChannel::ReceiveForwarded (uint32_t systemId, Ptr<const Transmission> tx, Ptr<const Packet> packet) const
+{
+#ifdef NS3_MULTITHREADED
+  // the propagation models and the partitions are shared by the threads
+  CriticalSection cs (m_mutex);
+  UpdateMovedCells ();
+#endif
+  Partition &partition = m_partitions[systemId];
+  std::vector<uint32_t> receivers;
+  if (m_maxRange > 0)
+    {
+      receivers = GetReceiversInRange (partition, tx->sender->GetPosition ());
+    }
+  else
+    {
+      ChannelReceivers::const_iterator i = partition.receivers.find (tx->channelNumber);
+      if (i != partition.receivers.end ())
+        {
+          receivers = i->second;
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
+    {
+      Ptr<YansWifiPhy> receiver = m_phyList[*i];
+      Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+      if (receiver->GetChannelNumber () != tx->channelNumber
+          || (m_maxRange > 0 && tx->sender->GetDistanceFrom (receiverMobility) > m_maxRange))
+        {
+          continue;
+        }
+      Time delay = m_delay->GetDelay (tx->sender, receiverMobility);
+      double rxPowerDbm = m_loss->CalcRxPower (tx->txPowerDbm, tx->sender, receiverMobility);
+      NS_LOG_DEBUG ("propagation: txPower=" << tx->txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                    "distance=" << tx->sender->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+      // the packet arrives a lookahead after it was sent: the reception
+      // starts the propagation delay later, so that the receptions keep
+      // the order of their delays.
+      Ptr<Node> node = GetNode (*i);
+      Simulator::ScheduleWithContext (node == 0 ? 0xffffffff : node->GetId (),
+                                      delay, &YansWifiChannel::Receive, this,
+                                      *i, packet, rxPowerDbm, tx->txVector, tx->preamble);
+    }
+}
+
 uint32_t
 YansWifiChannel::GetNDevices (void) const
 {
@@ -132,10 +524,80 @@ YansWifiChannel::GetDevice (uint32_t i) const
   return m_phyList[i]->GetDevice ()->GetObject<NetDevice> ();
 }
 
+Time
+YansWifiChannel::GetLookAhead (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Node> first = 0;
+  bool remote = false;
+  for (uint32_t i = 0; i < m_phyList.size () && !remote; i++)
+    {
+      Ptr<Node> node = GetNode (i);
+      if (first == 0)
+        {
+          first = node;
+        }
+      else if (node != 0 && node->GetSystemId () != first->GetSystemId ())
+        {
+          remote = true;
+        }
+    }
+  if (!remote)
+    {
+      return Seconds (0);
+    }
+  // the propagation delay may be as small as zero as nodes come close,
+  // whatever the delay model: the lookahead is the shortest preamble,
+  // so that a reception starts late by a fraction of its preamble at
+  // most.
+  uint32_t preamble = 0xffffffff;
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<YansWifiPhy> phy = m_phyList[i];
+      for (uint32_t j = 0; j < phy->GetNModes (); j++)
+        {
+          // the short preamble is the shortest one of every modulation class
+          preamble = std::min (preamble, WifiPhy::GetPlcpPreambleDurationMicroSeconds (phy->GetMode (j), WIFI_PREAMBLE_SHORT));
+        }
+      for (uint32_t j = 0; j < phy->GetNMcs (); j++)
+        {
+          preamble = std::min (preamble, WifiPhy::GetPlcpPreambleDurationMicroSeconds (phy->McsToWifiMode (phy->GetMcs (j)), WIFI_PREAMBLE_HT_MF));
+        }
+    }
+  NS_ASSERT (preamble != 0xffffffff);
+  NS_LOG_DEBUG ("preamble=" << preamble << "us");
+  return MicroSeconds (preamble);
+}
+
 void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
+  m_phyIndex[PeekPointer (phy)] = m_phyList.size ();
   m_phyList.push_back (phy);
+  m_moves.push_back (1);
+  m_partitionsValid = false;
+}
+
+void
+YansWifiChannel::NotifyChannelNumberChange (Ptr<YansWifiPhy> phy, uint16_t oldChannelNumber)
+{
+  NS_LOG_FUNCTION (this << phy << oldChannelNumber);
+#ifdef NS3_MULTITHREADED
+  CriticalSection cs (m_mutex);
+#endif
+  if (!m_partitionsValid)
+    {
+      return;
+    }
+  PhyIndex::const_iterator index = m_phyIndex.find (PeekPointer (phy));
+  NS_ASSERT_MSG (index != m_phyIndex.end (), "the PHY was not added to this channel");
+  ChannelReceivers &receivers = m_partitions[m_systemIds[index->second]].receivers;
+  std::vector<uint32_t> &from = receivers[oldChannelNumber];
+  std::vector<uint32_t>::iterator i = std::find (from.begin (), from.end (), index->second);
+  NS_ASSERT_MSG (i != from.end (), "the PHY does not operate on channel " << oldChannelNumber);
+  from.erase (i);
+  std::vector<uint32_t> &to = receivers[phy->GetChannelNumber ()];
+  to.insert (std::lower_bound (to.begin (), to.end (), index->second), index->second);
 }
 
 int64_t
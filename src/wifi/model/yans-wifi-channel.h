@@ -20,9 +20,17 @@
 #ifndef YANS_WIFI_CHANNEL_H
 #define YANS_WIFI_CHANNEL_H
 
+#include <map>
 #include <vector>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/core-config.h"
+#ifdef NS3_MULTITHREADED
+#include "ns3/system-mutex.h"
+#endif
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
@@ -31,6 +39,8 @@
 namespace ns3 {
 
 class NetDevice;
+class Node;
+class MobilityModel;
 class PropagationLossModel;
 class PropagationDelayModel;
 class YansWifiPhy;
@@ -46,6 +56,45 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * The PHYs are grouped by the channel number they operate on, so a
+ * transmission only visits the PHYs of its own channel number.
+ *
+ * When the MaxRange attribute is positive, a transmission reaches only the
+ * PHYs within MaxRange meters of the sender: the receivers are looked up in
+ * a grid of MaxRange-sized cells over the x-y plane, and the propagation
+ * models are not evaluated for the receivers out of range. Those receivers
+ * see neither the packet nor its interference. The grid is kept current by
+ * the CourseChange trace of the mobility models and is rebuilt when the
+ * fastest node may have left its cell. With a stochastic propagation loss
+ * model, such as NakagamiPropagationLossModel or RandomPropagationLossModel,
+ * the receivers out of range draw no random values, so all the later
+ * draws, and the results, differ from those without MaxRange.
+ *
+ * When the CacheLinks attribute is true, the rx power and the delay
+ * calculated for a pair of PHYs are reused for the next transmissions
+ * between them with the same tx power, as long as neither PHY moves: a
+ * link is only cached while both PHYs are at rest, and it is dropped by
+ * the CourseChange trace of either mobility model. This suits scenarios
+ * with many fixed nodes, such as road-side units and parked vehicles, but
+ * the cached values are only correct for propagation models without
+ * randomness, and for propagation models which are not reconfigured
+ * during the simulation. The links are kept in a dense matrix: every PHY
+ * which sends gets a row with an entry for each PHY of the channel. Once
+ * the cache holds MaxCachedLinks entries, it is emptied before the next
+ * row is added, and it is freed when the channel is disposed.
+ *
+ * The PHYs may be split across the partitions of a parallel simulation
+ * by the system id of their nodes, for example by region. A packet is
+ * forwarded to each of the other system ids than the sender a lookahead
+ * after it was sent, along with the position of the sender at that
+ * time: the partition of the system id then looks up its own PHYs on
+ * the channel number and within MaxRange, and applies the propagation
+ * models, so the mobility models of a partition are only read by its
+ * own thread. A reception thus starts a lookahead late, after the
+ * propagation delay: the lookahead is the shortest PLCP preamble of the
+ * PHYs. CacheLinks only applies to the PHYs of the system id of the
+ * sender.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -58,8 +107,26 @@ public:
   // inherited from Channel.
   virtual uint32_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+  /**
+   * \returns the shortest PLCP preamble of the modes of the PHYs, or zero
+   * if the PHYs all belong to the same system id.
+   *
+   * The propagation delay is not accounted for, as the delay models may
+   * make it as small as zero when two nodes are close, whatever their
+   * positions now. The receptions of the PHYs of other system ids than
+   * the sender thus start a lookahead late.
+   */
+  virtual Time GetLookAhead (void) const;
 
   void Add (Ptr<YansWifiPhy> phy);
+  /**
+   * \param phy a PHY of this channel whose channel number has changed
+   * \param oldChannelNumber the channel number the PHY operated on before
+   *
+   * This method is invoked by YansWifiPhy::SetChannelNumber to move the
+   * PHY to the receivers of its new channel number.
+   */
+  void NotifyChannelNumberChange (Ptr<YansWifiPhy> phy, uint16_t oldChannelNumber);
 
   /**
    * \param loss the new propagation loss model.
@@ -81,6 +148,10 @@ public:
    * currently invoked only from WifiPhy::Send. YansWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
    * e.g. PHYs that are operating on the same channel.
+   *
+   * The packet is not copied: all the receivers share it until one of
+   * them hands it up to its MAC, so the caller shall not modify the
+   * packet after this call.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
              WifiTxVector txVector, WifiPreamble preamble) const;
@@ -96,17 +167,155 @@ public:
   int64_t AssignStreams (int64_t stream);
 
 private:
+  virtual void DoDispose (void);
   YansWifiChannel& operator = (const YansWifiChannel &);
   YansWifiChannel (const YansWifiChannel &);
 
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
-  void Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
-                WifiTxVector txVector, WifiPreamble preamble) const;
+  // the indexes in m_phyList of the PHYs operating on each channel number,
+  // in ascending order.
+  typedef std::map<uint16_t, std::vector<uint32_t> > ChannelReceivers;
+  typedef std::pair<int32_t, int32_t> Cell;
+  typedef std::map<Cell, std::vector<uint32_t> > Grid;
+  /**
+   * The PHYs of the nodes of a system id, and their grid, which is only
+   * built from the positions of these PHYs.
+   */
+  struct Partition
+  {
+    uint32_t context;                // a node of the system id
+    std::vector<uint32_t> phys;      // in ascending order
+    ChannelReceivers receivers;
+    // the spatial index of the PHYs, only used when m_maxRange is positive.
+    Grid grid;
+    double maxSpeed;
+    Time gridTime;
+    bool gridValid;
+  };
+  typedef std::map<uint32_t, Partition> Partitions;
+  /**
+   * The propagation between two PHYs, as last calculated. It is valid
+   * while the course change counts of the PHYs are unchanged.
+   */
+  struct Link
+  {
+    uint32_t senderMoves;
+    uint32_t receiverMoves;
+    double txPowerDbm;
+    double rxPowerDbm;
+    Time delay;
+  };
+  typedef std::map<const YansWifiPhy *, uint32_t> PhyIndex;
+  /**
+   * A transmission forwarded to the other system ids than the sender,
+   * with all they need to calculate its propagation.
+   */
+  struct Transmission : public SimpleRefCount<Transmission>
+  {
+    Ptr<MobilityModel> sender;  // the position of the sender when it sent
+    uint16_t channelNumber;
+    double txPowerDbm;
+    WifiTxVector txVector;
+    WifiPreamble preamble;
+  };
+#ifdef NS3_MULTITHREADED
+  /**
+   * The position of a PHY after its course changed, as read by the
+   * partition of the PHY.
+   */
+  struct Move
+  {
+    uint32_t phy;
+    Vector position;
+    double speed;
+  };
+#endif
 
+  void Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
+                WifiTxVector txVector, WifiPreamble preamble) const;
+  /**
+   * \param systemId the system id whose PHYs receive the transmission
+   * \param tx the transmission, forwarded from another system id
+   * \param packet the packet of the system id
+   *
+   * Look up the PHYs of the system id on the channel number of the
+   * transmission and within MaxRange of the sender, calculate the
+   * propagation to each of them and start their receptions after the
+   * propagation delay from now, on the partition of the system id.
+   */
+  void ReceiveForwarded (uint32_t systemId, Ptr<const Transmission> tx, Ptr<const Packet> packet) const;
+  void SendTo (uint32_t i, uint32_t j, Ptr<MobilityModel> senderMobility,
+               Ptr<const Packet> packet, double txPowerDbm, WifiTxVector txVector,
+               WifiPreamble preamble) const;
+  /**
+   * \param i the index of a PHY in m_phyList
+   * \return the node of the PHY, or zero if it has no device.
+   */
+  Ptr<Node> GetNode (uint32_t i) const;
+  /**
+   * Group the PHYs by the system id of their nodes and by channel number
+   * in m_partitions, and calculate the lookahead, if a PHY was added
+   * since the last call.
+   */
+  void UpdatePartitions (void) const;
+  /**
+   * Drop all the cached links and free their memory.
+   */
+  void FlushLinks (void) const;
+  /**
+   * \param partition the partition whose PHYs are looked up
+   * \param position the position of the sender
+   * \return the indexes of the PHYs of the partition which may be within
+   * MaxRange of the position, in ascending order.
+   */
+  std::vector<uint32_t> GetReceiversInRange (Partition &partition, const Vector &position) const;
+  Cell GetCell (const Vector &position) const;
+  void BuildGrid (Partition &partition) const;
+  /**
+   * Connect to the CourseChange trace of the PHYs added since the last call.
+   */
+  void TrackCourseChanges (void) const;
+  void CourseChanged (uint32_t i, Ptr<const MobilityModel> mobility) const;
+  /**
+   * Move a PHY to the cell of its position in the grid of its partition,
+   * if the grid is valid.
+   */
+  void MoveToCell (uint32_t i, const Vector &position, double speed) const;
+#ifdef NS3_MULTITHREADED
+  /**
+   * Move the PHYs whose course changed since the last call to their cells.
+   */
+  void UpdateMovedCells (void) const;
+#endif
 
   PhyList m_phyList;
   Ptr<PropagationLossModel> m_loss;
   Ptr<PropagationDelayModel> m_delay;
+  double m_maxRange;
+  bool m_cacheLinks;
+  uint32_t m_maxCachedLinks;
+  PhyIndex m_phyIndex;
+
+  // the PHYs by system id, and the system id of each PHY, updated by the
+  // first transmission after a PHY was added, along with the lookahead.
+  mutable Partitions m_partitions;
+  mutable std::vector<uint32_t> m_systemIds;
+  mutable Time m_lookAhead;
+  mutable bool m_partitionsValid;
+  mutable std::vector<Cell> m_cells;   // the cell of each PHY in its grid
+  mutable uint32_t m_tracked;          // the PHYs connected to CourseChange
+  // the number of course changes of each PHY, from one, and the links
+  // cached by sender and receiver index, only used when m_cacheLinks is set.
+  mutable std::vector<uint32_t> m_moves;
+  mutable std::vector<std::vector<Link> > m_links;
+  mutable uint32_t m_nCachedLinks;     // the entries of all the rows of m_links
+#ifdef NS3_MULTITHREADED
+  // serializes the transmissions of the partitions running in parallel
+  mutable SystemMutex m_mutex;
+  // the PHYs whose course changed since the last Send, and their lock
+  mutable std::vector<Move> m_moved;
+  mutable SystemMutex m_movedMutex;
+#endif
 };
 
 } // namespace ns3
@@ -377,7 +377,12 @@ YansWifiPhy::SetChannelNumber (uint16_t nch)
     {
       // this is not channel switch, this is initialization
       NS_LOG_DEBUG ("start at channel " << nch);
+      uint16_t oldChannelNumber = m_channelNumber;
       m_channelNumber = nch;
+      if (m_channel != 0 && oldChannelNumber != nch)
+        {
+          m_channel->NotifyChannelNumberChange (this, oldChannelNumber);
+        }
       return;
     }
 
@@ -416,7 +421,12 @@ switchChannel:
    * state are added to the event list and are employed later to figure
    * out the state of the medium after the switching.
    */
+  uint16_t oldChannelNumber = m_channelNumber;
   m_channelNumber = nch;
+  if (m_channel != 0 && oldChannelNumber != nch)
+    {
+      m_channel->NotifyChannelNumberChange (this, oldChannelNumber);
+    }
 }
 
 uint16_t
@@ -442,7 +452,7 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
   m_state->SetReceiveErrorCallback (callback);
 }
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  double rxPowerDbm,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble)
@@ -784,7 +794,7 @@ YansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-YansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event)
+YansWifiPhy::EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
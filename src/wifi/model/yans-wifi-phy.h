@@ -92,7 +92,17 @@ public:
   /// Return current center channel frequency in MHz, see SetChannelNumber()
   double GetChannelFrequencyMhz () const;
 
-  void StartReceivePacket (Ptr<Packet> packet,
+  /**
+   * \param packet the packet being received, shared by all the receivers
+   *        of the transmission
+   * \param rxPowerDbm the receive power in dBm
+   * \param txVector the tx vector of the packet
+   * \param preamble the preamble of the packet
+   *
+   * The packet is handed up to the MAC as is: the MAC copies it only
+   * where it removes a header or a tag.
+   */
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiTxVector txVector,
                            WifiPreamble preamble);
@@ -124,6 +134,7 @@ public:
   virtual double GetTxPowerEnd (void) const;
   virtual uint32_t GetNTxPower (void) const;
   virtual void SetReceiveOkCallback (WifiPhy::RxOkCallback callback);
+  using WifiPhy::SetReceiveOkCallback;
   virtual void SetReceiveErrorCallback (WifiPhy::RxErrorCallback callback);
   virtual void SendPacket (Ptr<const Packet> packet, WifiMode mode, enum WifiPreamble preamble, WifiTxVector txvector);
   virtual void RegisterListener (WifiPhyListener *listener);
@@ -252,7 +263,7 @@ private:
   double WToDbm (double w) const;
   double RatioToDb (double ratio) const;
   double GetPowerDbm (uint8_t power) const;
-  void EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, Ptr<InterferenceHelper::Event> event);
 
 private:
   double   m_edThresholdW;
@@ -20,6 +20,8 @@
  *         Quincy Tse <quincy.tse@nicta.com.au> (Case for Bug 991)
  */
 
+#include <cmath>
+#include <algorithm>
 #include "ns3/wifi-net-device.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/adhoc-wifi-mac.h"
@@ -29,6 +31,9 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/interference-helper.h"
+#include "ns3/wifi-mac-queue.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
@@ -37,6 +42,9 @@
 #include "ns3/dca-txop.h"
 #include "ns3/mac-rx-middle.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/rng-seed-manager.h"
 
 namespace ns3 {
@@ -433,6 +441,876 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * The nodes of the tests of YansWifiChannel: each one has an 802.11a
+ * ad hoc device at a constant position, with a constant rate manager.
+ */
+class YansWifiChannelTestCase : public TestCase
+{
+public:
+  YansWifiChannelTestCase (std::string name);
+
+protected:
+  /**
+   * \param pos the position of the node
+   * \param channel the channel of the device of the node
+   * \param systemId the system id of the node
+   * \returns the node, whose device is its device 0
+   */
+  Ptr<Node> CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t systemId = 0);
+  /**
+   * \param dev the device which broadcasts a packet of 100 bytes
+   */
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+
+  ObjectFactory m_manager;
+  ObjectFactory m_mac;
+};
+
+YansWifiChannelTestCase::YansWifiChannelTestCase (std::string name)
+  : TestCase (name)
+{
+  m_mac.SetTypeId ("ns3::AdhocWifiMac");
+  m_manager.SetTypeId ("ns3::ConstantRateWifiManager");
+}
+
+void
+YansWifiChannelTestCase::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+Ptr<Node>
+YansWifiChannelTestCase::CreateOne (Vector pos, Ptr<YansWifiChannel> channel, uint32_t systemId)
+{
+  Ptr<Node> node = CreateObject<Node> (systemId);
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = m_mac.Create<WifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = m_manager.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return node;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel with a MaxRange delivers a transmission
+ * only to the PHYs in range, and follows the PHYs which move into range.
+ * The propagation loss is zero everywhere, so any PHY reached by the
+ * channel starts to receive.
+ */
+class MaxRangeTest : public YansWifiChannelTestCase
+{
+public:
+  MaxRangeTest ();
+
+  virtual void DoRun (void);
+private:
+  void FirstRx (Ptr<const Packet> packet);
+  void SecondRx (Ptr<const Packet> packet);
+
+  uint32_t m_firstRx;
+  uint32_t m_secondRx;
+};
+
+MaxRangeTest::MaxRangeTest ()
+  : YansWifiChannelTestCase ("YansWifiChannel MaxRange"),
+    m_firstRx (0),
+    m_secondRx (0)
+{
+}
+
+void
+MaxRangeTest::FirstRx (Ptr<const Packet> packet)
+{
+  m_firstRx++;
+}
+
+void
+MaxRangeTest::SecondRx (Ptr<const Packet> packet)
+{
+  m_secondRx++;
+}
+
+void
+MaxRangeTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<MatrixPropagationLossModel> propLoss = CreateObject<MatrixPropagationLossModel> ();
+  propLoss->SetDefaultLoss (0);
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (propLoss);
+  channel->SetAttribute ("MaxRange", DoubleValue (100.0));
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> first = CreateOne (Vector (50.0, 0.0, 0.0), channel);
+  Ptr<Node> second = CreateOne (Vector (0.0, -500.0, 0.0), channel);
+  first->GetDevice (0)->GetObject<WifiNetDevice> ()->GetPhy ()
+    ->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&MaxRangeTest::FirstRx, this));
+  second->GetDevice (0)->GetObject<WifiNetDevice> ()->GetPhy ()
+    ->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&MaxRangeTest::SecondRx, this));
+
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (sender->GetDevice (0));
+  Simulator::Schedule (Seconds (1.0), &MaxRangeTest::SendOnePacket, this, dev);
+  Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition,
+                       second->GetObject<MobilityModel> (), Vector (0.0, -99.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &MaxRangeTest::SendOnePacket, this, dev);
+  Simulator::Schedule (Seconds (4.0), &MobilityModel::SetPosition,
+                       first->GetObject<MobilityModel> (), Vector (150.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (5.0), &MaxRangeTest::SendOnePacket, this, dev);
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_firstRx, 2, "The first PHY shall receive the packets sent while it is in range");
+  NS_TEST_ASSERT_MSG_EQ (m_secondRx, 2, "The second PHY shall receive the packets sent after it moved into range");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel delivers a transmission to the PHYs
+ * operating on the channel number of the sender only, and follows the
+ * PHYs which switch channel.
+ */
+class ChannelNumberTest : public YansWifiChannelTestCase
+{
+public:
+  ChannelNumberTest ();
+
+  virtual void DoRun (void);
+private:
+  void SwitchCh (Ptr<WifiNetDevice> dev, uint16_t channelNumber);
+  void Rx (Ptr<const Packet> packet);
+
+  uint32_t m_rx;
+};
+
+ChannelNumberTest::ChannelNumberTest ()
+  : YansWifiChannelTestCase ("YansWifiChannel channel number"),
+    m_rx (0)
+{
+}
+
+void
+ChannelNumberTest::SwitchCh (Ptr<WifiNetDevice> dev, uint16_t channelNumber)
+{
+  dev->GetPhy ()->SetChannelNumber (channelNumber);
+}
+
+void
+ChannelNumberTest::Rx (Ptr<const Packet> packet)
+{
+  m_rx++;
+}
+
+void
+ChannelNumberTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> receiver = CreateOne (Vector (5.0, 0.0, 0.0), channel);
+  receiver->GetDevice (0)->GetObject<WifiNetDevice> ()->GetPhy ()
+    ->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&ChannelNumberTest::Rx, this));
+
+  Ptr<WifiNetDevice> txDev = DynamicCast<WifiNetDevice> (sender->GetDevice (0));
+  Ptr<WifiNetDevice> rxDev = DynamicCast<WifiNetDevice> (receiver->GetDevice (0));
+  Simulator::Schedule (Seconds (1.0), &ChannelNumberTest::SendOnePacket, this, txDev);
+  Simulator::Schedule (Seconds (2.0), &ChannelNumberTest::SwitchCh, this, rxDev, 2);
+  Simulator::Schedule (Seconds (3.0), &ChannelNumberTest::SendOnePacket, this, txDev);
+  Simulator::Schedule (Seconds (4.0), &ChannelNumberTest::SwitchCh, this, txDev, 2);
+  Simulator::Schedule (Seconds (5.0), &ChannelNumberTest::SendOnePacket, this, txDev);
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rx, 2, "The receiver shall receive the packets sent on its channel only");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel with CacheLinks drops the cached
+ * propagation of a link when the receiver moves: the receiver is moved
+ * out of the energy detection range of the sender, then back. The cache
+ * only holds one row, so it is emptied when the receiver sends.
+ */
+class LinkCacheTest : public YansWifiChannelTestCase
+{
+public:
+  LinkCacheTest ();
+
+  virtual void DoRun (void);
+private:
+  void RxBegin (Ptr<const Packet> packet);
+  void RxDrop (Ptr<const Packet> packet);
+
+  uint32_t m_rxBegin;
+  uint32_t m_rxDrop;
+};
+
+LinkCacheTest::LinkCacheTest ()
+  : YansWifiChannelTestCase ("YansWifiChannel CacheLinks"),
+    m_rxBegin (0),
+    m_rxDrop (0)
+{
+}
+
+void
+LinkCacheTest::RxBegin (Ptr<const Packet> packet)
+{
+  m_rxBegin++;
+}
+
+void
+LinkCacheTest::RxDrop (Ptr<const Packet> packet)
+{
+  m_rxDrop++;
+}
+
+void
+LinkCacheTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetAttribute ("CacheLinks", BooleanValue (true));
+  channel->SetAttribute ("MaxCachedLinks", UintegerValue (2));
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> receiver = CreateOne (Vector (5.0, 0.0, 0.0), channel);
+  Ptr<WifiPhy> phy = receiver->GetDevice (0)->GetObject<WifiNetDevice> ()->GetPhy ();
+  phy->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&LinkCacheTest::RxBegin, this));
+  phy->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&LinkCacheTest::RxDrop, this));
+
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (sender->GetDevice (0));
+  Simulator::Schedule (Seconds (1.0), &LinkCacheTest::SendOnePacket, this, dev);
+  Simulator::Schedule (Seconds (2.0), &LinkCacheTest::SendOnePacket, this, dev);
+  Simulator::Schedule (Seconds (3.0), &MobilityModel::SetPosition,
+                       receiver->GetObject<MobilityModel> (), Vector (100000.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (4.0), &LinkCacheTest::SendOnePacket, this, dev);
+  Simulator::Schedule (Seconds (5.0), &MobilityModel::SetPosition,
+                       receiver->GetObject<MobilityModel> (), Vector (5.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (6.0), &LinkCacheTest::SendOnePacket, this, dev);
+  Simulator::Schedule (Seconds (7.0), &LinkCacheTest::SendOnePacket, this,
+                       DynamicCast<WifiNetDevice> (receiver->GetDevice (0)));
+  Simulator::Schedule (Seconds (8.0), &LinkCacheTest::SendOnePacket, this, dev);
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxBegin, 4, "The receiver shall receive the packets sent while it is close");
+  NS_TEST_ASSERT_MSG_EQ (m_rxDrop, 1, "The receiver shall drop the packet sent while it is away");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a YansWifiChannel forwards a transmission to the PHYs of
+ * another system id than the sender a lookahead after it was sent, and
+ * that those PHYs start the reception after the propagation delay from
+ * then, but never before. With a MaxRange, the PHYs of the other system
+ * id out of range do not receive.
+ */
+class ForwardedReceptionTest : public YansWifiChannelTestCase
+{
+public:
+  ForwardedReceptionTest (double maxRange);
+
+  virtual void DoRun (void);
+private:
+  void TxBegin (Ptr<const Packet> packet);
+  void RxBegin (uint32_t i, Ptr<const Packet> packet);
+
+  double m_maxRange;
+  Time m_txStart;
+  std::vector<Time> m_rxStart;
+};
+
+ForwardedReceptionTest::ForwardedReceptionTest (double maxRange)
+  : YansWifiChannelTestCase (maxRange > 0 ? "YansWifiChannel forwarding to other system ids with MaxRange"
+                             : "YansWifiChannel forwarding to other system ids"),
+    m_maxRange (maxRange)
+{
+}
+
+void
+ForwardedReceptionTest::TxBegin (Ptr<const Packet> packet)
+{
+  m_txStart = Simulator::Now ();
+}
+
+void
+ForwardedReceptionTest::RxBegin (uint32_t i, Ptr<const Packet> packet)
+{
+  m_rxStart[i] = Simulator::Now ();
+}
+
+void
+ForwardedReceptionTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<PropagationDelayModel> delay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  channel->SetPropagationDelayModel (delay);
+  Ptr<FixedRssLossModel> loss = CreateObject<FixedRssLossModel> ();
+  loss->SetRss (-50);
+  channel->SetPropagationLossModel (loss);
+  channel->SetAttribute ("MaxRange", DoubleValue (m_maxRange));
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel, 0);
+  std::vector<Ptr<Node> > receivers;
+  // a local PHY, a close PHY and a PHY 6 km away of another system id,
+  // and a PHY of another system id on another channel number.
+  receivers.push_back (CreateOne (Vector (3.0, 0.0, 0.0), channel, 0));
+  receivers.push_back (CreateOne (Vector (3.0, 0.0, 0.0), channel, 1));
+  receivers.push_back (CreateOne (Vector (6000.0, 0.0, 0.0), channel, 1));
+  receivers.push_back (CreateOne (Vector (3.0, 0.0, 0.0), channel, 1));
+  receivers[3]->GetDevice (0)->GetObject<WifiNetDevice> ()->GetPhy ()->SetChannelNumber (2);
+  m_rxStart.resize (receivers.size (), Seconds (0));
+  for (uint32_t i = 0; i < receivers.size (); i++)
+    {
+      Ptr<WifiPhy> phy = receivers[i]->GetDevice (0)->GetObject<WifiNetDevice> ()->GetPhy ();
+      phy->TraceConnectWithoutContext ("PhyRxBegin", MakeCallback (&ForwardedReceptionTest::RxBegin, this).Bind (i));
+    }
+  Ptr<WifiNetDevice> dev = DynamicCast<WifiNetDevice> (sender->GetDevice (0));
+  dev->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&ForwardedReceptionTest::TxBegin, this));
+
+  // the shortest preamble of 802.11a
+  NS_TEST_ASSERT_MSG_EQ (channel->GetLookAhead (), MicroSeconds (16), "The lookahead shall be the shortest preamble");
+
+  Simulator::Schedule (Seconds (1.0), &ForwardedReceptionTest::SendOnePacket, this, dev);
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Ptr<MobilityModel> senderMobility = sender->GetObject<MobilityModel> ();
+  Time closeDelay = delay->GetDelay (senderMobility, receivers[0]->GetObject<MobilityModel> ());
+  Time distantDelay = delay->GetDelay (senderMobility, receivers[2]->GetObject<MobilityModel> ());
+  NS_TEST_ASSERT_MSG_EQ (m_rxStart[0], m_txStart + closeDelay, "The local PHY shall receive after the propagation delay");
+  NS_TEST_ASSERT_MSG_EQ (m_rxStart[1], m_txStart + MicroSeconds (16) + closeDelay, "The close PHY shall receive a lookahead late");
+  if (m_maxRange > 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxStart[2], Seconds (0), "The distant PHY shall be out of range");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_rxStart[2], m_txStart + MicroSeconds (16) + distantDelay, "The distant PHY shall receive a lookahead late");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_rxStart[3], Seconds (0), "The PHY on another channel number shall not receive");
+}
+
+//-----------------------------------------------------------------------------
+class NistErrorRateTableTest : public TestCase
+{
+public:
+  NistErrorRateTableTest ();
+
+  virtual void DoRun (void);
+};
+
+NistErrorRateTableTest::NistErrorRateTableTest ()
+  : TestCase ("NistErrorRateModel UseTables")
+{
+}
+
+void
+NistErrorRateTableTest::DoRun (void)
+{
+  Ptr<NistErrorRateModel> tables = CreateObject<NistErrorRateModel> ();
+  Ptr<NistErrorRateModel> calculated = CreateObject<NistErrorRateModel> ();
+  calculated->SetAttribute ("UseTables", BooleanValue (false));
+
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetErpOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate65MbpsBW20MHz ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  uint32_t nbits[] = { 1, 8, 200, 1600, 12000, 100000 };
+
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); mode++)
+    {
+      double maxError = 0.0;
+      std::vector<double> snrs;
+      for (double snrDb = -10.0; snrDb < 40.0; snrDb += 0.0137)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          snrs.push_back (snr);
+          for (uint32_t i = 0; i < sizeof (nbits) / sizeof (nbits[0]); i++)
+            {
+              double expected = calculated->GetChunkSuccessRate (*mode, snr, nbits[i]);
+              double actual = tables->GetChunkSuccessRate (*mode, snr, nbits[i]);
+              if (expected < 1e-300)
+                {
+                  NS_TEST_ASSERT_MSG_LT (actual, 1e-290, "A chunk received with a success rate of "
+                                         << actual << " rather than " << expected);
+                  continue;
+                }
+              maxError = std::max (maxError, std::abs (actual - expected) / expected);
+            }
+        }
+      NS_TEST_ASSERT_MSG_LT (maxError, 1e-6, "The interpolated success rates of " << *mode
+                             << " are not within 1e-6 of the calculated ones");
+
+      // the chunks of the batches spread across the SNRs, from below the
+      // tables to above them, save for those which are almost certainly lost.
+      for (uint32_t i = 0; i < 8; i++)
+        {
+          double expected = 1.0;
+          std::vector<double> batch;
+          std::vector<uint32_t> batchBits;
+          for (uint32_t j = i; j < snrs.size (); j += 8)
+            {
+              double chunk = calculated->GetChunkSuccessRate (*mode, snrs[j], 1 + j % 50);
+              if (chunk > 0.5)
+                {
+                  batch.push_back (snrs[j]);
+                  batchBits.push_back (1 + j % 50);
+                  expected *= chunk;
+                }
+            }
+          double actual = tables->GetChunksSuccessRate (*mode, &batch[0], &batchBits[0], batch.size ());
+          NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, 1e-6 * expected, "The success rate of a batch of chunks of "
+                                     << *mode << " is not within 1e-6 of the calculated one");
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+class InterferenceHelperEnergyTest : public TestCase
+{
+public:
+  InterferenceHelperEnergyTest ();
+
+  virtual void DoRun (void);
+private:
+  void Add (double powerW, Time duration);
+  void StartRx (double powerW, Time duration);
+  void EndRx (double expectedPer);
+  void CheckEnergyDuration (double energyW, Time expected);
+  /**
+   * \param signalW the power of the signal received at 6 Mbps
+   * \param interferenceW the power of the interference
+   * \param duration the duration of the chunk
+   * \returns the success rate of the chunk, calculated on its own
+   */
+  double GetChunkSuccessRate (double signalW, double interferenceW, Time duration);
+
+  InterferenceHelper m_interference;
+  Ptr<ErrorRateModel> m_error;
+  Ptr<InterferenceHelper::Event> m_rx;
+};
+
+InterferenceHelperEnergyTest::InterferenceHelperEnergyTest ()
+  : TestCase ("InterferenceHelper energy duration")
+{
+}
+
+void
+InterferenceHelperEnergyTest::Add (double powerW, Time duration)
+{
+  m_interference.Add (100, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, duration, powerW,
+                      WifiTxVector ());
+}
+
+void
+InterferenceHelperEnergyTest::StartRx (double powerW, Time duration)
+{
+  m_rx = m_interference.Add (100, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, duration, powerW,
+                             WifiTxVector ());
+  m_interference.NotifyRxStart ();
+}
+
+void
+InterferenceHelperEnergyTest::EndRx (double expectedPer)
+{
+  struct InterferenceHelper::SnrPer snrPer = m_interference.CalculateSnrPer (m_rx);
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.per, expectedPer, 1e-12,
+                             "Unexpected PER at " << Simulator::Now ().GetMicroSeconds () << "us");
+  m_interference.NotifyRxEnd ();
+  m_rx = 0;
+}
+
+double
+InterferenceHelperEnergyTest::GetChunkSuccessRate (double signalW, double interferenceW, Time duration)
+{
+  WifiMode mode = WifiPhy::GetOfdmRate6Mbps ();
+  // the thermal noise at 290K, times the noise figure
+  double noiseW = 1.3803e-23 * 290.0 * mode.GetBandwidth () * 5.0;
+  uint32_t nbits = (uint32_t)(mode.GetPhyRate () * duration.GetSeconds ());
+  return m_error->GetChunkSuccessRate (mode, signalW / (noiseW + interferenceW), nbits);
+}
+
+void
+InterferenceHelperEnergyTest::CheckEnergyDuration (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), expected,
+                         "Unexpected energy duration at " << Simulator::Now ().GetMicroSeconds () << "us");
+}
+
+void
+InterferenceHelperEnergyTest::DoRun (void)
+{
+  m_error = CreateObject<NistErrorRateModel> ();
+  m_interference.SetNoiseFigure (5.0);
+  m_interference.SetErrorRateModel (m_error);
+
+  // the PLCP header of the receptions at 6 Mbps with a long preamble
+  // lasts from 16 to 20us, and their payload starts at 20us: the PER of a
+  // reception is the product of the success rates of its chunks, where
+  // the interference is constant. The preamble does not count.
+  double firstPer = 1.0 - GetChunkSuccessRate (1e-9, 2e-9, MicroSeconds (4))
+    * GetChunkSuccessRate (1e-9, 6e-9, MicroSeconds (10))
+    * GetChunkSuccessRate (1e-9, 4e-9, MicroSeconds (70));
+  double secondPer = 1.0 - GetChunkSuccessRate (1e-10, 2e-11, MicroSeconds (4))
+    * GetChunkSuccessRate (1e-10, 5e-11, MicroSeconds (10))
+    * GetChunkSuccessRate (1e-10, 3e-11, MicroSeconds (70));
+  NS_TEST_ASSERT_MSG_EQ ((secondPer > 0.01 && secondPer < 0.99), true,
+                         "The second reception shall be neither certain to fail nor to succeed");
+
+  // a reception from 0 to 100us, interfered with from 10 to 30us and from
+  // 20 to 120us, then a signal from 110 to 130us after the reception.
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperEnergyTest::StartRx, this,
+                       1e-9, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperEnergyTest::Add, this,
+                       2e-9, MicroSeconds (20));
+  Simulator::Schedule (MicroSeconds (15), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       2.5e-9, MicroSeconds (15));
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperEnergyTest::Add, this,
+                       4e-9, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (25), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       6e-9, MicroSeconds (5));
+  Simulator::Schedule (MicroSeconds (25), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       4.5e-9, MicroSeconds (75));
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       4.5e-9, MicroSeconds (50));
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       1e-9, MicroSeconds (70));
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperEnergyTest::EndRx, this, firstPer);
+  Simulator::Schedule (MicroSeconds (100), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       1e-9, MicroSeconds (20));
+  Simulator::Schedule (MicroSeconds (110), &InterferenceHelperEnergyTest::Add, this,
+                       1e-9, MicroSeconds (20));
+  Simulator::Schedule (MicroSeconds (110), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       4.5e-9, MicroSeconds (10));
+  Simulator::Schedule (MicroSeconds (120), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       4.5e-9, MicroSeconds (0));
+  Simulator::Schedule (MicroSeconds (120), &InterferenceHelperEnergyTest::CheckEnergyDuration, this,
+                       0.5e-9, MicroSeconds (10));
+  // a weaker reception from 1000 to 1100us, interfered with from 1010 to
+  // 1030us and from 1020 to 1120us.
+  Simulator::Schedule (MicroSeconds (1000), &InterferenceHelperEnergyTest::StartRx, this,
+                       1e-10, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (1010), &InterferenceHelperEnergyTest::Add, this,
+                       2e-11, MicroSeconds (20));
+  Simulator::Schedule (MicroSeconds (1020), &InterferenceHelperEnergyTest::Add, this,
+                       3e-11, MicroSeconds (100));
+  Simulator::Schedule (MicroSeconds (1100), &InterferenceHelperEnergyTest::EndRx, this, secondPer);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class WifiMacQueueTest : public TestCase
+{
+public:
+  WifiMacQueueTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void Enqueue (uint32_t i, Mac48Address addr, uint8_t tid);
+  void PushFront (uint32_t i, Mac48Address addr, uint8_t tid);
+  void MoveToFront (uint32_t i);
+  bool IsMoved (Ptr<const Packet> packet, const WifiMacHeader *hdr);
+  /**
+   * Check the size of the queue and the packet at its head, if any.
+   */
+  void CheckHead (uint32_t size, int32_t head);
+  /**
+   * Check the number of packets to addr with tid, and the first of them, if any.
+   */
+  void CheckTidAndAddress (Mac48Address addr, uint8_t tid, uint32_t n, int32_t first);
+  void DequeueTidAndAddress (Mac48Address addr, uint8_t tid, int32_t expected);
+  void Remove (uint32_t i);
+
+  Ptr<WifiMacQueue> m_queue;
+  std::vector<Ptr<const Packet> > m_packets;
+  uint32_t m_moved;
+};
+
+WifiMacQueueTest::WifiMacQueueTest ()
+  : TestCase ("WifiMacQueue expiry and lookup by tid and address"),
+    m_moved (0)
+{
+}
+
+void
+WifiMacQueueTest::Enqueue (uint32_t i, Mac48Address addr, uint8_t tid)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (addr);
+  hdr.SetQosTid (tid);
+  m_queue->Enqueue (m_packets[i], hdr);
+}
+
+void
+WifiMacQueueTest::PushFront (uint32_t i, Mac48Address addr, uint8_t tid)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (addr);
+  hdr.SetQosTid (tid);
+  m_queue->PushFront (m_packets[i], hdr);
+}
+
+void
+WifiMacQueueTest::MoveToFront (uint32_t i)
+{
+  m_moved = i;
+  NS_TEST_EXPECT_MSG_EQ (m_queue->MoveToFront (MakeCallback (&WifiMacQueueTest::IsMoved, this)), true,
+                         "Packet " << i << " not moved");
+}
+
+bool
+WifiMacQueueTest::IsMoved (Ptr<const Packet> packet, const WifiMacHeader *hdr)
+{
+  return packet == m_packets[m_moved];
+}
+
+void
+WifiMacQueueTest::CheckHead (uint32_t size, int32_t head)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), size, "Wrong queue size at " << Simulator::Now ());
+  WifiMacHeader hdr;
+  Ptr<const Packet> packet = m_queue->Peek (&hdr);
+  Ptr<const Packet> expected = head < 0 ? 0 : m_packets[head];
+  NS_TEST_EXPECT_MSG_EQ (packet, expected, "Wrong head of queue at " << Simulator::Now ());
+}
+
+void
+WifiMacQueueTest::CheckTidAndAddress (Mac48Address addr, uint8_t tid, uint32_t n, int32_t first)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, addr), n,
+                         "Wrong number of packets to " << addr << " at " << Simulator::Now ());
+  WifiMacHeader hdr;
+  Ptr<const Packet> packet = m_queue->PeekByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, addr);
+  Ptr<const Packet> expected = first < 0 ? 0 : m_packets[first];
+  NS_TEST_EXPECT_MSG_EQ (packet, expected, "Wrong first packet to " << addr << " at " << Simulator::Now ());
+  if (packet != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (hdr.GetAddr1 (), addr, "Wrong header");
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)hdr.GetQosTid (), (uint32_t)tid, "Wrong header");
+    }
+}
+
+void
+WifiMacQueueTest::DequeueTidAndAddress (Mac48Address addr, uint8_t tid, int32_t expected)
+{
+  WifiMacHeader hdr;
+  Ptr<const Packet> packet = m_queue->DequeueByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, addr);
+  Ptr<const Packet> expectedPacket = expected < 0 ? 0 : m_packets[expected];
+  NS_TEST_EXPECT_MSG_EQ (packet, expectedPacket, "Wrong packet dequeued at " << Simulator::Now ());
+}
+
+void
+WifiMacQueueTest::Remove (uint32_t i)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (m_packets[i]), true, "Packet " << i << " not removed");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (m_packets[i]), false, "Packet " << i << " removed twice");
+}
+
+void
+WifiMacQueueTest::DoRun (void)
+{
+  Mac48Address a = Mac48Address ("00:00:00:00:00:01");
+  Mac48Address b = Mac48Address ("00:00:00:00:00:02");
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (MilliSeconds (10));
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      m_packets.push_back (Create<Packet> (100));
+    }
+
+  // packets 0 and 1 expire at 10ms, 2 and 3 at 14ms
+  Simulator::Schedule (MilliSeconds (0), &WifiMacQueueTest::Enqueue, this, 0, a, 0);
+  Simulator::Schedule (MilliSeconds (0), &WifiMacQueueTest::Enqueue, this, 1, b, 0);
+  Simulator::Schedule (MilliSeconds (4), &WifiMacQueueTest::Enqueue, this, 2, a, 0);
+  Simulator::Schedule (MilliSeconds (4), &WifiMacQueueTest::Enqueue, this, 3, a, 1);
+  // packet 4 is pushed in front of the older ones and expires at 16ms
+  Simulator::Schedule (MilliSeconds (6), &WifiMacQueueTest::PushFront, this, 4, b, 0);
+  Simulator::Schedule (MilliSeconds (7), &WifiMacQueueTest::CheckHead, this, 5, 4);
+  Simulator::Schedule (MilliSeconds (7), &WifiMacQueueTest::CheckTidAndAddress, this, a, 0, 2, 0);
+  Simulator::Schedule (MilliSeconds (7), &WifiMacQueueTest::CheckTidAndAddress, this, a, 1, 1, 3);
+  Simulator::Schedule (MilliSeconds (7), &WifiMacQueueTest::CheckTidAndAddress, this, b, 0, 2, 4);
+  Simulator::Schedule (MilliSeconds (7), &WifiMacQueueTest::CheckTidAndAddress, this, b, 1, 0, -1);
+
+  Simulator::Schedule (MilliSeconds (12), &WifiMacQueueTest::CheckHead, this, 3, 4);
+  Simulator::Schedule (MilliSeconds (12), &WifiMacQueueTest::CheckTidAndAddress, this, a, 0, 1, 2);
+  Simulator::Schedule (MilliSeconds (12), &WifiMacQueueTest::CheckTidAndAddress, this, b, 0, 1, 4);
+  // packets 5 and 6 expire at 22ms, 7 at 25ms
+  Simulator::Schedule (MilliSeconds (12), &WifiMacQueueTest::Enqueue, this, 5, b, 0);
+  Simulator::Schedule (MilliSeconds (12), &WifiMacQueueTest::Enqueue, this, 6, a, 0);
+  Simulator::Schedule (MilliSeconds (13), &WifiMacQueueTest::DequeueTidAndAddress, this, b, 0, 4);
+  Simulator::Schedule (MilliSeconds (13), &WifiMacQueueTest::CheckHead, this, 4, 2);
+  Simulator::Schedule (MilliSeconds (15), &WifiMacQueueTest::PushFront, this, 7, a, 0);
+  Simulator::Schedule (MilliSeconds (15), &WifiMacQueueTest::CheckHead, this, 3, 7);
+  Simulator::Schedule (MilliSeconds (15), &WifiMacQueueTest::CheckTidAndAddress, this, a, 0, 2, 7);
+  Simulator::Schedule (MilliSeconds (15), &WifiMacQueueTest::CheckTidAndAddress, this, a, 1, 0, -1);
+  Simulator::Schedule (MilliSeconds (16), &WifiMacQueueTest::Remove, this, 6);
+  Simulator::Schedule (MilliSeconds (16), &WifiMacQueueTest::CheckTidAndAddress, this, a, 0, 1, 7);
+  Simulator::Schedule (MilliSeconds (16), &WifiMacQueueTest::CheckHead, this, 2, 7);
+  Simulator::Schedule (MilliSeconds (23), &WifiMacQueueTest::CheckHead, this, 1, 7);
+  Simulator::Schedule (MilliSeconds (23), &WifiMacQueueTest::CheckTidAndAddress, this, b, 0, 0, -1);
+  Simulator::Schedule (MilliSeconds (26), &WifiMacQueueTest::CheckHead, this, 0, -1);
+  Simulator::Schedule (MilliSeconds (26), &WifiMacQueueTest::CheckTidAndAddress, this, a, 0, 0, -1);
+  // the queue is reusable once empty
+  Simulator::Schedule (MilliSeconds (27), &WifiMacQueueTest::Enqueue, this, 0, a, 0);
+  Simulator::Schedule (MilliSeconds (27), &WifiMacQueueTest::CheckTidAndAddress, this, a, 0, 1, 0);
+  // packet 0 expires at 37ms, 1 at 40ms, 2 at 41ms. Packet 1 keeps its
+  // time stamp when it is moved in front of the more recent packet 2
+  Simulator::Schedule (MilliSeconds (30), &WifiMacQueueTest::Enqueue, this, 1, b, 0);
+  Simulator::Schedule (MilliSeconds (31), &WifiMacQueueTest::PushFront, this, 2, b, 1);
+  Simulator::Schedule (MilliSeconds (32), &WifiMacQueueTest::MoveToFront, this, 1);
+  Simulator::Schedule (MilliSeconds (32), &WifiMacQueueTest::CheckHead, this, 3, 1);
+  Simulator::Schedule (MilliSeconds (32), &WifiMacQueueTest::CheckTidAndAddress, this, b, 0, 1, 1);
+  Simulator::Schedule (MilliSeconds (38), &WifiMacQueueTest::CheckHead, this, 2, 1);
+  Simulator::Schedule (MilliSeconds (40), &WifiMacQueueTest::CheckHead, this, 1, 2);
+  Simulator::Schedule (MilliSeconds (40), &WifiMacQueueTest::CheckTidAndAddress, this, b, 0, 0, -1);
+  Simulator::Schedule (MilliSeconds (41), &WifiMacQueueTest::CheckHead, this, 0, -1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+  m_packets.clear ();
+}
+
+//-----------------------------------------------------------------------------
+class StationIdleTimeoutTest : public TestCase
+{
+public:
+  StationIdleTimeoutTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void LookupAll (uint32_t n);
+  void Lookup (uint32_t i);
+  void CheckStations (uint32_t n);
+  void CheckStates (void);
+
+  Ptr<WifiRemoteStationManager> m_manager;
+  std::vector<Mac48Address> m_addresses;
+};
+
+StationIdleTimeoutTest::StationIdleTimeoutTest ()
+  : TestCase ("WifiRemoteStationManager lookup and StationIdleTimeout")
+{
+}
+
+void
+StationIdleTimeoutTest::LookupAll (uint32_t n)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  Ptr<const Packet> packet = Create<Packet> (100);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      hdr.SetAddr1 (m_addresses[i]);
+      hdr.SetQosTid (i % 3);
+      m_manager->GetDataTxVector (m_addresses[i], &hdr, packet, 128);
+      hdr.SetQosTid (0);
+      m_manager->ReportDataOk (m_addresses[i], &hdr, 20, WifiMode ("OfdmRate6Mbps"), 20);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsBrandNew (m_addresses[n - 1]), true, "Wrong state");
+}
+
+void
+StationIdleTimeoutTest::Lookup (uint32_t i)
+{
+  m_manager->IsBrandNew (m_addresses[i]);
+}
+
+void
+StationIdleTimeoutTest::CheckStations (uint32_t n)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_manager->GetNRemoteStations (), n,
+                         "Wrong number of remote stations at " << Simulator::Now ());
+}
+
+void
+StationIdleTimeoutTest::CheckStates (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsAssociated (m_addresses[0]), true, "Associated station deleted");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsWaitAssocTxOk (m_addresses[1]), true, "Associating station deleted");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsBrandNew (m_addresses[2]), false, "Active station deleted");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->IsBrandNew (m_addresses[3]), true, "Idle station kept");
+}
+
+void
+StationIdleTimeoutTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  m_manager = CreateObject<ArfWifiManager> ();
+  m_manager->SetAttribute ("StationIdleTimeout", TimeValue (Seconds (1)));
+  m_manager->SetupPhy (phy);
+  for (uint32_t i = 0; i < 1001; i++)
+    {
+      m_addresses.push_back (Mac48Address::Allocate ());
+    }
+
+  Simulator::Schedule (Seconds (0), &StationIdleTimeoutTest::LookupAll, this, 1000);
+  Simulator::Schedule (Seconds (0), &WifiRemoteStationManager::RecordGotAssocTxOk, m_manager, m_addresses[0]);
+  Simulator::Schedule (Seconds (0), &WifiRemoteStationManager::RecordWaitAssocTxOk, m_manager, m_addresses[1]);
+  Simulator::Schedule (Seconds (0), &WifiRemoteStationManager::RecordDisassociated, m_manager, m_addresses[2]);
+  Simulator::Schedule (Seconds (0), &StationIdleTimeoutTest::CheckStations, this, 1000);
+  Simulator::Schedule (Seconds (0.8), &StationIdleTimeoutTest::Lookup, this, 2);
+  // the lookups of the known stations do not delete the idle ones
+  Simulator::Schedule (Seconds (1.5), &StationIdleTimeoutTest::Lookup, this, 2);
+  Simulator::Schedule (Seconds (1.5), &StationIdleTimeoutTest::CheckStations, this, 1000);
+  // a new station does
+  Simulator::Schedule (Seconds (2), &StationIdleTimeoutTest::Lookup, this, 1000);
+  Simulator::Schedule (Seconds (2), &StationIdleTimeoutTest::CheckStations, this, 4);
+  Simulator::Schedule (Seconds (2), &StationIdleTimeoutTest::CheckStates, this);
+  Simulator::Schedule (Seconds (2), &StationIdleTimeoutTest::CheckStations, this, 5);
+  // the deleted stations start over
+  Simulator::Schedule (Seconds (2), &StationIdleTimeoutTest::LookupAll, this, 1000);
+  Simulator::Schedule (Seconds (2), &StationIdleTimeoutTest::CheckStations, this, 1001);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_manager->Dispose ();
+  m_manager = 0;
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -447,6 +1325,15 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
+  AddTestCase (new MaxRangeTest, TestCase::QUICK);
+  AddTestCase (new ChannelNumberTest, TestCase::QUICK);
+  AddTestCase (new LinkCacheTest, TestCase::QUICK);
+  AddTestCase (new ForwardedReceptionTest (0.0), TestCase::QUICK);
+  AddTestCase (new ForwardedReceptionTest (1000.0), TestCase::QUICK);
+  AddTestCase (new NistErrorRateTableTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperEnergyTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueTest, TestCase::QUICK);
+  AddTestCase (new StationIdleTimeoutTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
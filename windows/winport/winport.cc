@@ -195,3 +195,16 @@ isblank (char v)
 	//std::cout << "isblank" << std::endl;
   return isspace (v);
 }
+
+double
+log1p (double v)
+{
+  // log (1 + v) loses the low bits of v when v is small: scale it by
+  // v / (u - 1), which restores them
+  double u = 1.0 + v;
+  if (u == 1.0)
+    {
+      return v;
+    }
+  return log (u) * v / (u - 1.0);
+}
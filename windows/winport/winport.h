@@ -41,6 +41,7 @@ bool isblank (char v);
 uint64_t lrint (double v);
 long double ceil (uint32_t v);
 long double abs (uint32_t v);
+double log1p (double v);
 #define erfc gsl_sf_erfc
 #define erf(x) (1-gsl_sf_erfc(x))
 double  gsl_sf_erfc(double x);